@@ -0,0 +1,685 @@
+/* Micro-benchmarks of the queue operations */
+
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Our program needs to use regular malloc/free */
+#define INTERNAL 1
+#include "harness.h"
+
+#include "bench.h"
+#include "list.h"
+#include "mpmc.h"
+#include "queue.h"
+#include "random.h"
+#include "report.h"
+
+/* Same lengths and characters as the random strings of qtest */
+#define BENCH_MIN_LEN 5
+#define BENCH_MAX_LEN 10
+static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
+
+/* Next value of a splitmix sequence. Much cheaper than asking randombytes()
+ * for every string, which matters when building large queues.
+ */
+static inline uintptr_t bench_rand(uintptr_t *state)
+{
+    *state += (uintptr_t) 0x9e3779b97f4a7c15ULL;
+    return random_shuffle(*state);
+}
+
+static void bench_rand_string(char *buf, uintptr_t *state)
+{
+    size_t len =
+        BENCH_MIN_LEN + bench_rand(state) % (BENCH_MAX_LEN - BENCH_MIN_LEN + 1);
+
+    for (size_t i = 0; i < len; i++)
+        buf[i] = charset[bench_rand(state) % (sizeof(charset) - 1)];
+    buf[len] = '\0';
+}
+
+/* Build a queue of n random strings and remember the order of its nodes in
+ * nodes, so that every run can start from the same input.
+ */
+static struct list_head *bench_queue_new(int n, struct list_head **nodes)
+{
+    struct list_head *head = q_new(), *iter = NULL;
+    char buf[BENCH_MAX_LEN + 1];
+    uintptr_t state = 0;
+    int i = 0;
+
+    if (head == NULL)
+        return NULL;
+
+    randombytes((uint8_t *) &state, sizeof(state));
+    for (i = 0; i < n; i++) {
+        bench_rand_string(buf, &state);
+        if (!q_insert_tail(head, buf)) {
+            q_free(head);
+            return NULL;
+        }
+    }
+
+    i = 0;
+    list_for_each (iter, head)
+        nodes[i++] = iter;
+    return head;
+}
+
+/* Build a queue of n strings drawn from n / 2 distinct random values, so that
+ * most values occur more than once, in an order given by seed.
+ */
+static struct list_head *bench_dup_queue_new(int n, uintptr_t seed)
+{
+    struct list_head *head = q_new();
+    char buf[BENCH_MAX_LEN + 1];
+
+    if (head == NULL)
+        return NULL;
+
+    for (int i = 0; i < n; i++) {
+        uintptr_t value = bench_rand(&seed) % (n / 2 + 1);
+        bench_rand_string(buf, &value);
+        if (!q_insert_tail(head, buf)) {
+            q_free(head);
+            return NULL;
+        }
+    }
+    return head;
+}
+
+static void bench_queue_restore(struct list_head *head,
+                                struct list_head **nodes,
+                                int n)
+{
+    INIT_LIST_HEAD(head);
+    for (int i = 0; i < n; i++)
+        list_add_tail(nodes[i], head);
+}
+
+static bool bench_sorted(struct list_head *head)
+{
+    struct list_head *iter = NULL;
+
+    /* Sorting a presorted queue may only flip its direction */
+    q_sync(head);
+    list_for_each (iter, head) {
+        if (iter->next == head)
+            break;
+        if (strcmp(list_entry(iter, element_t, list)->value,
+                   list_entry(iter->next, element_t, list)->value) > 0)
+            return false;
+    }
+    return true;
+}
+
+/* Default sizes of the benchmarks */
+#define BENCH_SORT_N 1000000
+#define BENCH_DEDUP_N 10000000
+#define BENCH_REMOVE_N 1000000
+#define BENCH_BACKEND_N 1000000
+#define BENCH_REVERSEK_N 1000000
+
+/* Buffer size 'rh' passes with the default maximum string length */
+#define BENCH_REMOVE_BUFSIZE 1025
+static const int bench_merge_n[] = {1000000, 4000000, 16000000};
+
+/* Group sizes of 'bench reverseK' */
+static const int bench_reverseK_k[] = {2, 16, 1024};
+
+/* Elements per producer and capacity of the queue of 'stress' */
+#define STRESS_N 100000
+#define STRESS_CAPACITY 1024
+static const int bench_stress_threads[] = {1, 2, 4};
+
+bool bench_sort(int n)
+{
+    static const struct {
+        const char *name;
+        int prefix_mode, radix;
+        bool threads;
+    } runs[] = {
+        {"list_sort, prefix off", 0, 0, false},
+        {"list_sort, prefix on", 1, 0, false},
+        {"radix sort", 1, 1, false},
+        {"radix sort, threads", 1, 1, true},
+    };
+    if (!n)
+        n = BENCH_SORT_N;
+
+    struct list_head **nodes = malloc(sizeof(*nodes) * n);
+    struct list_head *head = nodes ? bench_queue_new(n, nodes) : NULL;
+    int saved_prefix_mode = q_prefix_mode, saved_radix_min = q_radix_min;
+    int saved_threads = q_sort_threads;
+    bool ok = true;
+
+    if (head == NULL) {
+        report(1, "ERROR: Could not allocate a queue of %d elements", n);
+        free(nodes);
+        return false;
+    }
+
+    for (size_t r = 0; ok && r < sizeof(runs) / sizeof(runs[0]); r++) {
+        double timer;
+
+        /* The threaded run is only of interest with more than one thread */
+        if (runs[r].threads && saved_threads <= 1)
+            continue;
+
+        bench_queue_restore(head, nodes, n);
+        q_prefix_mode = runs[r].prefix_mode;
+        q_radix_min = runs[r].radix;
+        q_sort_threads = runs[r].threads ? saved_threads : 1;
+        q_compare_count = 0;
+        init_time(&timer);
+        q_sort(head);
+        double elapsed = delta_time(&timer);
+
+        ok = bench_sorted(head);
+        if (!ok) {
+            report(1, "ERROR: Not sorted in ascending order");
+            break;
+        }
+        report(1,
+               "sort %d, %s: %.3f s, %lu comparisons, "
+               "%.1f M comparisons/s",
+               n, runs[r].name, elapsed, q_compare_count,
+               elapsed > 0 ? q_compare_count / elapsed / 1e6 : 0.0);
+    }
+
+    q_prefix_mode = saved_prefix_mode;
+    q_radix_min = saved_radix_min;
+    q_sort_threads = saved_threads;
+    q_free(head);
+    free(nodes);
+    return ok;
+}
+
+bool bench_merge(int n)
+{
+    if (!n) {
+        bool ok = true;
+        for (size_t i = 0; ok && i < sizeof(bench_merge_n) / sizeof(int); i++)
+            ok = bench_merge(bench_merge_n[i]);
+        return ok;
+    }
+
+    struct list_head **nodes = malloc(sizeof(*nodes) * n);
+    struct list_head *head = nodes ? bench_queue_new(n, nodes) : NULL;
+    int saved_radix_min = q_radix_min, saved_threads = q_sort_threads;
+    double timer;
+
+    if (head == NULL) {
+        report(1, "ERROR: Could not allocate a queue of %d elements", n);
+        free(nodes);
+        return false;
+    }
+
+    q_radix_min = 0;
+    q_sort_threads = 1;
+    q_compare_count = 0;
+    init_time(&timer);
+    q_sort(head);
+    double elapsed = delta_time(&timer);
+    q_radix_min = saved_radix_min;
+    q_sort_threads = saved_threads;
+
+    bool ok = bench_sorted(head);
+    if (ok)
+        report(1, "merge sort %d: %.3f s, %lu comparisons, %.1f ns/element", n,
+               elapsed, q_compare_count, elapsed * 1e9 / n);
+    else
+        report(1, "ERROR: Not sorted in ascending order");
+
+    q_free(head);
+    free(nodes);
+    return ok;
+}
+
+bool bench_dedup(int n)
+{
+    static const char *const runs[] = {"unsorted", "sort + dedup"};
+    uintptr_t seed = 0;
+    bool ok = true;
+
+    if (!n)
+        n = BENCH_DEDUP_N;
+    randombytes((uint8_t *) &seed, sizeof(seed));
+
+    for (size_t r = 0; ok && r < sizeof(runs) / sizeof(runs[0]); r++) {
+        struct list_head *head = bench_dup_queue_new(n, seed);
+        double timer;
+
+        if (head == NULL) {
+            report(1, "ERROR: Could not allocate a queue of %d elements", n);
+            return false;
+        }
+
+        init_time(&timer);
+        if (r == 0) {
+            ok = q_delete_dup_unsorted(head);
+        } else {
+            q_sort(head);
+            ok = q_delete_dup(head);
+        }
+        double elapsed = delta_time(&timer);
+
+        if (ok)
+            report(1, "dedup %d, %s: %.3f s, %d distinct strings left", n,
+                   runs[r], elapsed, q_size(head));
+        else
+            report(1, "ERROR: Could not delete duplicates");
+        q_free(head);
+    }
+    return ok;
+}
+
+bool bench_remove(int n)
+{
+    static const struct {
+        const char *name;
+        bool copy;
+    } runs[] = {
+        {"copy", true},
+        {"no copy", false},
+    };
+    static char sp[BENCH_REMOVE_BUFSIZE];
+
+    if (!n)
+        n = BENCH_REMOVE_N;
+
+    struct list_head **nodes = malloc(sizeof(*nodes) * n);
+    if (nodes == NULL) {
+        report(1, "ERROR: Could not allocate a queue of %d elements", n);
+        return false;
+    }
+
+    for (size_t r = 0; r < sizeof(runs) / sizeof(runs[0]); r++) {
+        struct list_head *head = bench_queue_new(n, nodes);
+        element_t **removed = (element_t **) nodes;
+        double timer;
+
+        if (head == NULL) {
+            report(1, "ERROR: Could not allocate a queue of %d elements", n);
+            free(nodes);
+            return false;
+        }
+
+        /* Release the elements afterwards, so that only removal is timed */
+        init_time(&timer);
+        for (int i = 0; i < n; i++) {
+            removed[i] = runs[r].copy ? q_remove_head(head, sp, sizeof(sp))
+                                      : q_remove_head(head, NULL, 0);
+        }
+        double elapsed = delta_time(&timer);
+
+        for (int i = 0; i < n; i++)
+            q_release_element(removed[i]);
+        q_free(head);
+        report(1, "remove %d, %s: %.3f s, %.1f ns/element", n, runs[r].name,
+               elapsed, elapsed * 1e9 / n);
+    }
+
+    free(nodes);
+    return true;
+}
+
+/* Keeps the walk of the queue from being optimized away */
+static volatile char bench_sink;
+
+bool bench_backend(int n)
+{
+    static const struct {
+        const char *name;
+        int backend;
+    } runs[] = {
+        {"list", Q_BACKEND_LIST},
+        {"ring", Q_BACKEND_RING},
+    };
+    int saved_backend = q_backend;
+    bool ok = true;
+
+    if (!n)
+        n = BENCH_BACKEND_N;
+
+    for (size_t r = 0; ok && r < sizeof(runs) / sizeof(runs[0]); r++) {
+        char buf[BENCH_MAX_LEN + 1];
+        uintptr_t state = 0;
+        element_t *e = NULL;
+        double timer, fill, walk, cycle;
+
+        q_backend = runs[r].backend;
+        struct list_head *head = q_new();
+        q_backend = saved_backend;
+        if (head == NULL) {
+            ok = false;
+            break;
+        }
+
+        init_time(&timer);
+        for (int i = 0; ok && i < n; i++) {
+            bench_rand_string(buf, &state);
+            ok = q_insert_tail(head, buf);
+        }
+        fill = delta_time(&timer);
+
+        list_for_each_entry (e, head, list)
+            bench_sink = e->value[0];
+        walk = delta_time(&timer);
+
+        /* Every element passes through the queue once more */
+        for (int i = 0; ok && i < n; i++) {
+            bench_rand_string(buf, &state);
+            ok = q_insert_tail(head, buf);
+            q_release_element(q_remove_head(head, NULL, 0));
+        }
+        cycle = delta_time(&timer);
+
+        q_free(head);
+        if (!ok) {
+            report(1, "ERROR: Could not allocate a queue of %d elements", n);
+            break;
+        }
+        report(1,
+               "backend %d, %s: fill %.1f ns, walk %.1f ns, "
+               "FIFO cycle %.1f ns per element",
+               n, runs[r].name, fill * 1e9 / n, walk * 1e9 / n,
+               cycle * 1e9 / n);
+    }
+
+    return ok;
+}
+
+/* Reverse the nodes of head k at a time the way q_reverseK() used to: move
+ * each group node by node onto a list of its own, reverse that list, and
+ * splice it onto the result.
+ */
+static void bench_reverseK_splice(struct list_head *head, int k)
+{
+    struct list_head *iter = head->next, *next = iter->next;
+    LIST_HEAD(res_head);
+
+    for (int i = q_size(head) / k; i > 0; i--) {
+        LIST_HEAD(tmp_head);
+
+        for (int j = 0; j < k; j++) {
+            list_move_tail(iter, &tmp_head);
+            iter = next;
+            next = iter->next;
+        }
+
+        struct list_head *node = NULL, *safe = NULL, *tmp = NULL;
+        list_for_each_safe (node, safe, &tmp_head) {
+            tmp = node->prev;
+            node->prev = node->next;
+            node->next = tmp;
+        }
+        tmp = tmp_head.next;
+        tmp_head.next = tmp_head.prev;
+        tmp_head.prev = tmp;
+
+        list_splice_tail(&tmp_head, &res_head);
+    }
+
+    list_splice(&res_head, head);
+}
+
+/* Check that the nodes of head, which were in the order of nodes, have been
+ * reversed k at a time, the nodes after the last whole group left in place
+ */
+static bool bench_reversedK(struct list_head *head,
+                            struct list_head **nodes,
+                            int n,
+                            int k)
+{
+    struct list_head *iter = head->next;
+
+    for (int i = 0; i < n; i++, iter = iter->next) {
+        int group = i - i % k;
+        int j = group + k <= n ? 2 * group + k - 1 - i : i;
+        if (iter != nodes[j])
+            return false;
+    }
+    return iter == head;
+}
+
+bool bench_reverseK(int n)
+{
+    if (!n)
+        n = BENCH_REVERSEK_N;
+
+    struct list_head **nodes = malloc(sizeof(*nodes) * n);
+    struct list_head *head = nodes ? bench_queue_new(n, nodes) : NULL;
+    int saved_ktail = q_ktail_mode;
+    bool ok = true;
+
+    if (head == NULL) {
+        report(1, "ERROR: Could not allocate a queue of %d elements", n);
+        free(nodes);
+        return false;
+    }
+
+    /* The old way leaves the last group alone */
+    q_ktail_mode = 0;
+    for (size_t r = 0;
+         ok && r < sizeof(bench_reverseK_k) / sizeof(bench_reverseK_k[0]);
+         r++) {
+        int k = bench_reverseK_k[r];
+        double timer, splice, in_place;
+
+        bench_queue_restore(head, nodes, n);
+        init_time(&timer);
+        bench_reverseK_splice(head, k);
+        splice = delta_time(&timer);
+        ok = bench_reversedK(head, nodes, n, k);
+
+        bench_queue_restore(head, nodes, n);
+        init_time(&timer);
+        q_reverseK(head, k);
+        in_place = delta_time(&timer);
+        ok = ok && bench_reversedK(head, nodes, n, k);
+
+        if (!ok) {
+            report(1, "ERROR: Not reversed %d at a time", k);
+            break;
+        }
+        report(1,
+               "reverseK %d, k = %d: splice %.1f ns, in place %.1f ns per "
+               "element",
+               n, k, splice * 1e9 / n, in_place * 1e9 / n);
+    }
+
+    q_ktail_mode = saved_ktail;
+    q_free(head);
+    free(nodes);
+    return ok;
+}
+
+/* State shared by the threads of a stress run */
+struct stress {
+    mpmc_t *q;
+    int producers, n;
+    atomic_long consumed;
+    atomic_bool failed;
+    /* Whether each element, by producer and sequence number, was popped */
+    atomic_uchar *seen;
+};
+
+struct stress_thread {
+    struct stress *s;
+    int id;
+    pthread_t thread;
+    bool spawned;
+};
+
+static void stress_fail(struct stress *s, const char *msg)
+{
+    /* Report only the first failure, the other threads stop on it */
+    if (!atomic_exchange(&s->failed, true))
+        report(1, "ERROR: %s", msg);
+}
+
+/* Push n elements, each carrying its producer and sequence number in the
+ * string and in the key.
+ */
+static void *stress_producer(void *arg)
+{
+    struct stress_thread *t = arg;
+    struct stress *s = t->s;
+    char buf[32];
+
+    for (int seq = 0; seq < s->n && !atomic_load(&s->failed); seq++) {
+        int len = snprintf(buf, sizeof(buf), "%d:%d", t->id, seq);
+        element_t *e = malloc(sizeof(element_t) + len + 1);
+
+        if (e == NULL) {
+            stress_fail(s, "Could not allocate an element");
+            break;
+        }
+        e->value = memcpy(e->inline_value, buf, len + 1);
+        e->key = (uint64_t) t->id << 32 | seq;
+        e->flags = 0;
+        INIT_LIST_HEAD(&e->list);
+        while (!mpmc_push(s->q, e)) {
+            if (atomic_load(&s->failed)) {
+                free(e);
+                return NULL;
+            }
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* Pop elements until all have been popped, checking that each is intact, was
+ * not popped before, and comes after the earlier ones of its producer.
+ */
+static void *stress_consumer(void *arg)
+{
+    struct stress_thread *t = arg;
+    struct stress *s = t->s;
+    long total = (long) s->producers * s->n;
+    int *last = malloc(sizeof(int) * s->producers);
+    char buf[32];
+
+    if (last == NULL) {
+        stress_fail(s, "Could not allocate a consumer");
+        return NULL;
+    }
+    for (int p = 0; p < s->producers; p++)
+        last[p] = -1;
+
+    while (atomic_load(&s->consumed) < total && !atomic_load(&s->failed)) {
+        element_t *e = mpmc_pop(s->q);
+        if (e == NULL) {
+            sched_yield();
+            continue;
+        }
+
+        int p = e->key >> 32, seq = e->key & 0xffffffff;
+        snprintf(buf, sizeof(buf), "%d:%d", p, seq);
+        if (p >= s->producers || seq >= s->n || strcmp(e->value, buf))
+            stress_fail(s, "Popped a corrupted element");
+        else if (atomic_exchange(&s->seen[(long) p * s->n + seq], 1))
+            stress_fail(s, "Popped an element twice");
+        else if (seq <= last[p])
+            stress_fail(s, "Popped elements of a producer out of order");
+        else
+            last[p] = seq;
+        free(e);
+        atomic_fetch_add(&s->consumed, 1);
+    }
+
+    free(last);
+    return NULL;
+}
+
+bool bench_stress(int producers, int consumers, int n)
+{
+    if (!producers) {
+        bool ok = true;
+        for (size_t i = 0;
+             ok && i < sizeof(bench_stress_threads) / sizeof(int); i++)
+            ok = bench_stress(bench_stress_threads[i],
+                              bench_stress_threads[i], n);
+        return ok;
+    }
+
+    if (!n)
+        n = STRESS_N;
+
+    int threads = producers + consumers;
+    long total = (long) producers * n;
+    struct stress s = {
+        .q = mpmc_new(STRESS_CAPACITY),
+        .producers = producers,
+        .n = n,
+        .seen = calloc(total, sizeof(atomic_uchar)),
+    };
+    struct stress_thread *t = calloc(threads, sizeof(*t));
+    sigset_t alarm, saved;
+    double timer;
+
+    atomic_init(&s.consumed, 0);
+    atomic_init(&s.failed, false);
+    if (s.q == NULL || s.seen == NULL || t == NULL) {
+        report(1, "ERROR: Could not allocate a queue of %d elements",
+               STRESS_CAPACITY);
+        mpmc_free(s.q);
+        free(s.seen);
+        free(t);
+        return false;
+    }
+
+    /* SIGALRM stays blocked in the workers, as in the parallel sort */
+    sigemptyset(&alarm);
+    sigaddset(&alarm, SIGALRM);
+    pthread_sigmask(SIG_BLOCK, &alarm, &saved);
+    init_time(&timer);
+    for (int i = 0; i < threads; i++) {
+        t[i].s = &s;
+        t[i].id = i < producers ? i : i - producers;
+        t[i].spawned = !pthread_create(
+            &t[i].thread, NULL,
+            i < producers ? stress_producer : stress_consumer, &t[i]);
+        if (!t[i].spawned) {
+            stress_fail(&s, "Could not create a thread");
+            break;
+        }
+    }
+    pthread_sigmask(SIG_SETMASK, &saved, NULL);
+
+    for (int i = 0; i < threads; i++) {
+        if (t[i].spawned)
+            pthread_join(t[i].thread, NULL);
+    }
+    double elapsed = delta_time(&timer);
+
+    /* Elements left behind by a failed run */
+    for (element_t *e; (e = mpmc_pop(s.q));)
+        free(e);
+
+    bool ok = !atomic_load(&s.failed);
+    for (long i = 0; ok && i < total; i++) {
+        if (!atomic_load(&s.seen[i]))
+            stress_fail(&s, "An element was lost");
+        ok = !atomic_load(&s.failed);
+    }
+    if (ok)
+        report(1,
+               "stress %d producers, %d consumers, %d elements each: "
+               "%.3f s, %.2f M ops/s",
+               producers, consumers, n, elapsed,
+               elapsed > 0 ? 2.0 * total / elapsed / 1e6 : 0.0);
+
+    mpmc_free(s.q);
+    free(s.seen);
+    free(t);
+    return ok;
+}
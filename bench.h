@@ -0,0 +1,71 @@
+#ifndef LAB0_BENCH_H
+#define LAB0_BENCH_H
+
+#include <stdbool.h>
+
+/* Micro-benchmarks of the queue operations, run by the 'bench' command */
+
+/* Sort n random strings with list_sort(), with and without the cached key
+ * prefix, and with the radix sort, single-threaded and, if the 'threads'
+ * option allows, on several threads. Report the comparisons per second of
+ * each run. n == 0 sorts 1M strings.
+ *
+ * Return: true for success, false if the queue could not be built or sorted
+ */
+bool bench_sort(int n);
+
+/* Merge sort n random strings, single-threaded and without radix sort, and
+ * report the time per element. n == 0 runs 1M, 4M and 16M strings in turn.
+ *
+ * Return: true for success, false if the queue could not be built or sorted
+ */
+bool bench_merge(int n);
+
+/* Delete the duplicates of a queue of n strings drawn from n / 2 values, with
+ * q_delete_dup_unsorted() and with q_sort() followed by q_delete_dup(), and
+ * report the time of each. n == 0 uses 10M strings.
+ *
+ * Return: true for success, false if the queue could not be built or the
+ * duplicates could not be deleted
+ */
+bool bench_dedup(int n);
+
+/* Remove all n random strings of a queue from its head, copying each string
+ * into a buffer as 'rh' does, and without the copy, and report the time per
+ * element of each. n == 0 removes 1M strings.
+ *
+ * Return: true for success, false if the queue could not be built
+ */
+bool bench_remove(int n);
+
+/* Fill a queue with n random strings, walk it, and pass n more strings
+ * through it, inserting at the tail and removing from the head, once with
+ * each backend. Report the time per element of each step. n == 0 uses 1M
+ * strings.
+ *
+ * Return: true for success, false if the queue could not be built
+ */
+bool bench_backend(int n);
+
+/* Reverse a queue of n random strings 2, 16 and 1024 nodes at a time, once by
+ * moving each group onto a list of its own and splicing it back, as
+ * q_reverseK() used to, and once with q_reverseK(), and report the time per
+ * element of each. n == 0 uses 1M strings.
+ *
+ * Return: true for success, false if the queue could not be built or was not
+ * reversed correctly
+ */
+bool bench_reverseK(int n);
+
+/* Pass n elements from each of the producer threads to the consumer threads
+ * through a concurrent queue, check that every element arrives exactly once
+ * and in the order of its producer, and report the pushes and pops per
+ * second. n == 0 uses 100K elements per producer, producers == 0 runs 1, 2
+ * and 4 threads on each side in turn.
+ *
+ * Return: true for success, false if an element was lost, duplicated,
+ * reordered or corrupted, or if the run could not be set up
+ */
+bool bench_stress(int producers, int consumers, int n);
+
+#endif /* LAB0_BENCH_H */
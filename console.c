@@ -93,6 +93,16 @@ void add_cmd(char *name, cmd_func_t operation, char *summary, char *param)
 
 /* Add a new parameter */
 void add_param(char *name, int *valp, char *summary, setter_func_t setter)
+{
+    add_param_names(name, valp, NULL, summary, setter);
+}
+
+/* Add a new parameter whose values also go by name */
+void add_param_names(char *name,
+                     int *valp,
+                     const char *const *names,
+                     char *summary,
+                     setter_func_t setter)
 {
     param_element_t *next_param = param_list;
     param_element_t **last_loc = &param_list;
@@ -105,6 +115,7 @@ void add_param(char *name, int *valp, char *summary, setter_func_t setter)
         malloc_or_fail(sizeof(param_element_t), "add_param");
     param->name = name;
     param->valp = valp;
+    param->names = names;
     param->summary = summary;
     param->setter = setter;
     param->next = next_param;
@@ -250,6 +261,20 @@ static bool do_quit(int argc, char *argv[])
     return ok;
 }
 
+/* Show the value of a parameter, by name if it has one */
+static void report_param(param_element_t *p)
+{
+    int n = 0;
+    while (p->names && p->names[n])
+        n++;
+
+    if (*p->valp >= 0 && *p->valp < n)
+        report(1, "  %-12s%-12s | %s", p->name, p->names[*p->valp],
+               p->summary);
+    else
+        report(1, "  %-12s%-12d | %s", p->name, *p->valp, p->summary);
+}
+
 static bool do_help(int argc, char *argv[])
 {
     cmd_element_t *clist = cmd_list;
@@ -262,8 +287,7 @@ static bool do_help(int argc, char *argv[])
     param_element_t *plist = param_list;
     report(1, "Options:");
     while (plist) {
-        report(1, "  %-12s%-12d | %s", plist->name, *plist->valp,
-               plist->summary);
+        report_param(plist);
         plist = plist->next;
     }
     return true;
@@ -301,8 +325,7 @@ static bool do_option(int argc, char *argv[])
         param_element_t *plist = param_list;
         report(1, "Options:");
         while (plist) {
-            report(1, "  %-12s%-12d | %s", plist->name, *plist->valp,
-                   plist->summary);
+            report_param(plist);
             plist = plist->next;
         }
         return true;
@@ -311,32 +334,37 @@ static bool do_option(int argc, char *argv[])
     for (int i = 1; i < argc; i++) {
         char *name = argv[i];
         int value = 0;
-        bool found = false;
         /* Get value from next argument */
         if (i + 1 >= argc) {
             report(1, "No value given for parameter %s", name);
             return false;
-        } else if (!get_int(argv[++i], &value)) {
-            report(1, "Cannot parse '%s' as integer", argv[i]);
-            return false;
         }
         /* Find parameter in list */
         param_element_t *plist = param_list;
-        while (!found && plist) {
-            if (strcmp(plist->name, name) == 0) {
-                int oldval = *plist->valp;
-                *plist->valp = value;
-                if (plist->setter)
-                    plist->setter(oldval);
-                found = true;
-            } else
-                plist = plist->next;
-        }
+        while (plist && strcmp(plist->name, name) != 0)
+            plist = plist->next;
         /* Didn't find parameter */
-        if (!found) {
+        if (!plist) {
             report(1, "Unknown parameter '%s'", name);
             return false;
         }
+
+        bool parsed = get_int(argv[++i], &value);
+        for (int v = 0; !parsed && plist->names && plist->names[v]; v++) {
+            if (strcmp(plist->names[v], argv[i]) == 0) {
+                value = v;
+                parsed = true;
+            }
+        }
+        if (!parsed) {
+            report(1, "Cannot parse '%s' as integer", argv[i]);
+            return false;
+        }
+
+        int oldval = *plist->valp;
+        *plist->valp = value;
+        if (plist->setter)
+            plist->setter(oldval);
     }
 
     return true;
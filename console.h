@@ -34,6 +34,8 @@ typedef void (*setter_func_t)(int oldval);
 typedef struct __param_element {
     char *name;
     int *valp;
+    /* Names of values 0, 1, ..., NULL-terminated, or NULL if there are none */
+    const char *const *names;
     char *summary;
     /* Function that gets called whenever parameter changes */
     setter_func_t setter;
@@ -50,6 +52,13 @@ void add_cmd(char *name, cmd_func_t operation, char *summary, char *parameter);
 /* Add a new parameter */
 void add_param(char *name, int *valp, char *summary, setter_func_t setter);
 
+/* Add a new parameter whose values may also be given by name */
+void add_param_names(char *name,
+                     int *valp,
+                     const char *const *names,
+                     char *summary,
+                     setter_func_t setter);
+
 /* Extract integer from text and store at loc */
 bool get_int(char *vname, int *loc);
 
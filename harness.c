@@ -1,7 +1,10 @@
 /* Test support code */
 
+#define _GNU_SOURCE /* dladdr */
+#include <dlfcn.h>
 #include <setjmp.h>
 #include <signal.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -27,25 +30,50 @@
 /* Byte to fill newly malloced space with */
 #define FILLCHAR 0x55
 
+/* Initial number of slots in the set of allocated blocks, a power of 2 */
+#define BLOCK_SET_MIN 1024
+
+/* Number of call sites the allocation profiler can tell apart, a power of 2 */
+#define ALLOCPROF_SLOTS 512
+
 /* Data structures used by our code */
 
-/* Represent allocated blocks as doubly-linked list, with
- * next and prev pointers at beginning
- */
+/* Header placed in front of every allocated block */
 typedef struct __block_element {
-    struct __block_element *next, *prev;
     size_t payload_size;
-    size_t magic_header; /* Marker to see if block seems legitimate */
+    uint32_t site;         /* Profile slot of the call site plus 1, or 0 */
+    uint32_t magic_header; /* Marker to see if block seems legitimate */
     unsigned char payload[0];
     /* Also place magic number at tail of every block */
 } block_element_t;
 
-static block_element_t *allocated = NULL;
+/* Allocation statistics of one call site */
+typedef struct {
+    void *site; /* Return address of the call to the allocator */
+    size_t calls;
+    size_t bytes; /* Total bytes requested */
+    size_t live;  /* Bytes currently allocated */
+    size_t peak;  /* Maximum of live */
+} alloc_site_t;
+
+/* Allocated blocks are tracked by an open-addressing hash set keyed by block
+ * address, using linear probing. Looking up a block to be freed is O(1)
+ * expected, so cautious mode stays affordable for huge queues.
+ * The set is at most half full.
+ */
+static block_element_t **block_set = NULL;
+static size_t block_set_size = 0; /* Number of slots */
 static size_t allocated_count = 0;
 
 /* Percent probability of malloc failure */
 int fail_probability = 0;
 
+/* Nonzero to record allocations per call site. The profile lives in a static
+ * table so that profiling never allocates by itself.
+ */
+int allocprof_mode = 0;
+static alloc_site_t alloc_sites[ALLOCPROF_SLOTS];
+
 static bool cautious_mode = true;
 static bool noallocate_mode = false;
 static bool error_occurred = false;
@@ -67,6 +95,120 @@ static bool fail_allocation()
     return (weight < 0.01 * fail_probability);
 }
 
+/* Home slot of block in the hash set. Blocks allocated one after another sit
+ * close to each other, so keep the low address bits in order to have their
+ * slots share cache lines, and fold the high bits in to spread the arenas.
+ */
+static inline size_t block_hash(const block_element_t *b)
+{
+    uintptr_t a = (uintptr_t) b;
+    return ((a >> 4) ^ (a >> 28)) & (block_set_size - 1);
+}
+
+/* Return the slot holding block b, or block_set_size if it is not in set */
+static size_t block_set_find(const block_element_t *b)
+{
+    if (!block_set)
+        return block_set_size;
+
+    for (size_t i = block_hash(b);; i = (i + 1) & (block_set_size - 1)) {
+        if (block_set[i] == b)
+            return i;
+        if (!block_set[i])
+            return block_set_size;
+    }
+}
+
+static void block_set_place(block_element_t *b)
+{
+    size_t i = block_hash(b);
+    while (block_set[i])
+        i = (i + 1) & (block_set_size - 1);
+    block_set[i] = b;
+}
+
+/* Rehash all blocks into a set with the given number of slots */
+static bool block_set_resize(size_t size)
+{
+    block_element_t **old_set = block_set;
+    size_t old_size = block_set_size;
+
+    block_set = calloc(size, sizeof(block_element_t *));
+    if (!block_set) {
+        block_set = old_set;
+        return false;
+    }
+    block_set_size = size;
+
+    for (size_t i = 0; i < old_size; i++) {
+        if (old_set[i])
+            block_set_place(old_set[i]);
+    }
+    free(old_set);
+    return true;
+}
+
+static bool block_set_insert(block_element_t *b)
+{
+    size_t size = block_set_size ? 2 * block_set_size : BLOCK_SET_MIN;
+    if (2 * (allocated_count + 1) > block_set_size && !block_set_resize(size))
+        return false;
+
+    block_set_place(b);
+    return true;
+}
+
+/* Remove the block at slot i, shifting back the following blocks of the
+ * probe sequence so that no tombstone is needed.
+ */
+static void block_set_remove(size_t i)
+{
+    size_t mask = block_set_size - 1;
+
+    for (size_t j = (i + 1) & mask; block_set[j]; j = (j + 1) & mask) {
+        size_t home = block_hash(block_set[j]);
+        /* Move the block into the hole unless its home lies in (i, j] */
+        bool stays =
+            i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (!stays) {
+            block_set[i] = block_set[j];
+            i = j;
+        }
+    }
+    block_set[i] = NULL;
+}
+
+/* Return the profile slot of call site plus 1, or 0 when the table is full */
+static uint32_t allocprof_slot(void *site)
+{
+    size_t mask = ALLOCPROF_SLOTS - 1;
+    size_t i = ((uintptr_t) site >> 2) & mask;
+
+    for (size_t n = 0; n < ALLOCPROF_SLOTS; n++, i = (i + 1) & mask) {
+        if (alloc_sites[i].site == site)
+            return i + 1;
+        if (!alloc_sites[i].site) {
+            alloc_sites[i].site = site;
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+static void allocprof_record(block_element_t *b, void *site)
+{
+    b->site = allocprof_slot(site);
+    if (!b->site)
+        return;
+
+    alloc_site_t *s = &alloc_sites[b->site - 1];
+    s->calls++;
+    s->bytes += b->payload_size;
+    s->live += b->payload_size;
+    if (s->live > s->peak)
+        s->peak = s->live;
+}
+
 /* Find header of block, given its payload.
  * Signal error if doesn't seem like legitimate block
  */
@@ -81,13 +223,7 @@ static block_element_t *find_header(void *p)
         (block_element_t *) ((size_t) p - sizeof(block_element_t));
     if (cautious_mode) {
         /* Make sure this is really an allocated block */
-        block_element_t *ab = allocated;
-        bool found = false;
-        while (ab && !found) {
-            found = ab == b;
-            ab = ab->next;
-        }
-        if (!found) {
+        if (block_set_find(b) == block_set_size) {
             report_event(MSG_ERROR,
                          "Attempted to free unallocated block.  Address = %p",
                          p);
@@ -117,7 +253,8 @@ static size_t *find_footer(block_element_t *b)
 
 /* Implementation of application functions */
 
-void *test_malloc(size_t size)
+/* Allocate a block on behalf of the code at site */
+static void *alloc_block(size_t size, void *site)
 {
     if (noallocate_mode) {
         report_event(MSG_FATAL, "Calls to malloc disallowed");
@@ -131,7 +268,7 @@ void *test_malloc(size_t size)
 
     block_element_t *new_block =
         malloc(size + sizeof(block_element_t) + sizeof(size_t));
-    if (!new_block) {
+    if (!new_block || !block_set_insert(new_block)) {
         report_event(MSG_FATAL, "Couldn't allocate any more memory");
         error_occurred = true;
     }
@@ -143,19 +280,20 @@ void *test_malloc(size_t size)
     *find_footer(new_block) = MAGICFOOTER;
     void *p = (void *) &new_block->payload;
     memset(p, FILLCHAR, size);
-    // cppcheck-suppress nullPointerRedundantCheck
-    new_block->next = allocated;
-    // cppcheck-suppress nullPointerRedundantCheck
-    new_block->prev = NULL;
-
-    if (allocated)
-        allocated->prev = new_block;
-    allocated = new_block;
     allocated_count++;
 
+    new_block->site = 0;
+    if (allocprof_mode)
+        allocprof_record(new_block, site);
+
     return p;
 }
 
+void *test_malloc(size_t size)
+{
+    return alloc_block(size, __builtin_return_address(0));
+}
+
 // cppcheck-suppress unusedFunction
 void *test_calloc(size_t nelem, size_t elsize)
 {
@@ -163,7 +301,7 @@ void *test_calloc(size_t nelem, size_t elsize)
      * https://danluu.com/malloc-tutorial/
      */
     size_t size = nelem * elsize;  // TODO: check for overflow
-    void *ptr = test_malloc(size);
+    void *ptr = alloc_block(size, __builtin_return_address(0));
     memset(ptr, 0, size);
     return ptr;
 }
@@ -190,16 +328,13 @@ void test_free(void *p)
     b->magic_header = MAGICFREE;
     *find_footer(b) = MAGICFREE;
     memset(p, FILLCHAR, b->payload_size);
+    if (b->site)
+        alloc_sites[b->site - 1].live -= b->payload_size;
 
-    /* Unlink from list */
-    block_element_t *bn = b->next;
-    block_element_t *bp = b->prev;
-    if (bp)
-        bp->next = bn;
-    else
-        allocated = bn;
-    if (bn)
-        bn->prev = bp;
+    /* Remove from the set of allocated blocks */
+    size_t slot = block_set_find(b);
+    if (slot != block_set_size)
+        block_set_remove(slot);
 
     free(b);
     allocated_count--;
@@ -209,7 +344,7 @@ void test_free(void *p)
 char *test_strdup(const char *s)
 {
     size_t len = strlen(s) + 1;
-    void *new = test_malloc(len);
+    void *new = alloc_block(len, __builtin_return_address(0));
     if (!new)
         return NULL;
 
@@ -221,6 +356,56 @@ size_t allocation_check()
     return allocated_count;
 }
 
+static int allocprof_cmp(const void *a, const void *b)
+{
+    size_t x = alloc_sites[*(const uint32_t *) a].bytes;
+    size_t y = alloc_sites[*(const uint32_t *) b].bytes;
+    return (x < y) - (x > y);
+}
+
+/* Describe call site as function+offset. Sites outside of exported functions
+ * are described as an offset into their module, which addr2line resolves.
+ */
+static void allocprof_name(void *site, char *buf, size_t size)
+{
+    Dl_info info;
+
+    if (!dladdr(site, &info) || !info.dli_fname) {
+        snprintf(buf, size, "%p", site);
+    } else if (info.dli_sname) {
+        snprintf(buf, size, "%s+0x%lx", info.dli_sname,
+                 (unsigned long) ((char *) site - (char *) info.dli_saddr));
+    } else {
+        const char *module = strrchr(info.dli_fname, '/');
+        snprintf(buf, size, "%s+0x%lx", module ? module + 1 : info.dli_fname,
+                 (unsigned long) ((char *) site - (char *) info.dli_fbase));
+    }
+}
+
+/* Show the call sites which allocated most bytes, at most limit of them */
+void allocprof_report(int limit)
+{
+    static uint32_t order[ALLOCPROF_SLOTS];
+    int n = 0;
+
+    for (uint32_t i = 0; i < ALLOCPROF_SLOTS; i++) {
+        if (alloc_sites[i].site)
+            order[n++] = i;
+    }
+    qsort(order, n, sizeof(order[0]), allocprof_cmp);
+
+    report(1, "%-32s %10s %12s %12s %12s", "Site", "Calls", "Bytes", "Live",
+           "Peak");
+    for (int i = 0; i < n && i < limit; i++) {
+        alloc_site_t *s = &alloc_sites[order[i]];
+        char name[64];
+
+        allocprof_name(s->site, name, sizeof(name));
+        report(1, "%-32s %10zu %12zu %12zu %12zu", name, s->calls, s->bytes,
+               s->live, s->peak);
+    }
+}
+
 /* Implementation of functions for testing */
 
 /* Set/unset cautious mode.
@@ -24,6 +24,12 @@ size_t allocation_check();
 /* Probability of malloc failing, expressed as percent */
 extern int fail_probability;
 
+/* Nonzero to record bytes, calls and peak live memory per call site */
+extern int allocprof_mode;
+
+/* Show the call sites which allocated most bytes, at most limit of them */
+void allocprof_report(int limit);
+
 /*
  * Set/unset cautious mode.
  * In this mode, makes extra sure any block to be freed is currently allocated.
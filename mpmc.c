@@ -0,0 +1,123 @@
+/* Bounded multi-producer, multi-consumer queue of elements */
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "mpmc.h"
+
+/* Keeps the counters written by producers and by consumers on cache lines of
+ * their own
+ */
+#define MPMC_CACHE_LINE 64
+
+/* A cell is ready for the producer at position pos when its sequence number is
+ * pos, and for the consumer at position pos when it is pos + 1.
+ */
+struct mpmc_cell {
+    atomic_size_t seq;
+    element_t *e;
+};
+
+struct mpmc {
+    struct mpmc_cell *cells;
+    size_t mask;
+    char pad0[MPMC_CACHE_LINE];
+    atomic_size_t tail;
+    char pad1[MPMC_CACHE_LINE - sizeof(atomic_size_t)];
+    atomic_size_t head;
+    char pad2[MPMC_CACHE_LINE - sizeof(atomic_size_t)];
+};
+
+mpmc_t *mpmc_new(size_t capacity)
+{
+    size_t size = 2;
+
+    while (size < capacity)
+        size <<= 1;
+
+    mpmc_t *q = malloc(sizeof(mpmc_t));
+    if (q == NULL)
+        return NULL;
+    q->cells = malloc(size * sizeof(q->cells[0]));
+    if (q->cells == NULL) {
+        free(q);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < size; i++) {
+        atomic_init(&q->cells[i].seq, i);
+        q->cells[i].e = NULL;
+    }
+    q->mask = size - 1;
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->head, 0);
+    return q;
+}
+
+void mpmc_free(mpmc_t *q)
+{
+    if (q == NULL)
+        return;
+
+    free(q->cells);
+    free(q);
+}
+
+bool mpmc_push(mpmc_t *q, element_t *e)
+{
+    size_t pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    struct mpmc_cell *cell = NULL;
+
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+
+        if (diff == 0) {
+            /* On failure, pos is reloaded with the current tail */
+            if (atomic_compare_exchange_weak_explicit(&q->tail, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* The consumer of the previous lap has not freed the cell yet */
+            return false;
+        } else {
+            pos = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        }
+    }
+
+    cell->e = e;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+    return true;
+}
+
+element_t *mpmc_pop(mpmc_t *q)
+{
+    size_t pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+    struct mpmc_cell *cell = NULL;
+
+    for (;;) {
+        cell = &q->cells[pos & q->mask];
+        size_t seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+
+        if (diff == 0) {
+            if (atomic_compare_exchange_weak_explicit(&q->head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        } else if (diff < 0) {
+            /* No producer has published the cell for this lap yet */
+            return NULL;
+        } else {
+            pos = atomic_load_explicit(&q->head, memory_order_relaxed);
+        }
+    }
+
+    element_t *e = cell->e;
+    /* Ready for the producer of the next lap */
+    atomic_store_explicit(&cell->seq, pos + q->mask + 1, memory_order_release);
+    return e;
+}
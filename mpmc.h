@@ -0,0 +1,64 @@
+#ifndef LAB0_MPMC_H
+#define LAB0_MPMC_H
+
+/* Bounded queue of elements which any number of threads may push to and pop
+ * from concurrently.
+ *
+ * The queue is a ring of cells, each carrying a sequence number which tells
+ * whether the cell is ready to be written for the lap of the ring a producer
+ * is on, or ready to be read for the lap a consumer is on. Producers and
+ * consumers claim positions with a compare-and-swap on the tail or the head
+ * counter and never touch the same cell at the same time. No thread waits on
+ * a lock; a thread preempted between claiming a cell and publishing it only
+ * holds up the threads which reach that cell on the other side.
+ *
+ * The queue only passes element_t pointers around. The elements are owned by
+ * whichever thread pushed or popped them last.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "queue.h"
+
+typedef struct mpmc mpmc_t;
+
+/**
+ * mpmc_new() - Create an empty concurrent queue
+ * @capacity: number of elements it can hold, rounded up to a power of two
+ *
+ * Must not be called concurrently with other operations on the queue.
+ *
+ * Return: the new queue, or NULL for allocation failed
+ */
+mpmc_t *mpmc_new(size_t capacity);
+
+/**
+ * mpmc_free() - Free a concurrent queue
+ * @q: the queue
+ *
+ * Elements still in the queue are not released. Must not be called
+ * concurrently with other operations on the queue.
+ */
+void mpmc_free(mpmc_t *q);
+
+/**
+ * mpmc_push() - Append an element to a concurrent queue
+ * @q: the queue
+ * @e: the element
+ *
+ * Return: true for success, false if the queue is full
+ */
+bool mpmc_push(mpmc_t *q, element_t *e);
+
+/**
+ * mpmc_pop() - Take the oldest element of a concurrent queue
+ * @q: the queue
+ *
+ * Elements pushed by one thread are popped in the order they were pushed.
+ *
+ * Return: the element, or NULL if the queue is empty
+ */
+element_t *mpmc_pop(mpmc_t *q);
+
+#endif /* LAB0_MPMC_H */
@@ -44,6 +44,7 @@ extern int show_entropy;
  */
 #include "queue.h"
 
+#include "bench.h"
 #include "console.h"
 #include "report.h"
 
@@ -53,7 +54,6 @@ extern int show_entropy;
 
 /* How large is a queue before it's considered big.
  * This affects how it gets printed
- * and whether cautious mode is used when freeing the queue
  */
 #define BIG_LIST_SIZE 30
 
@@ -73,6 +73,11 @@ static int fail_count = 0;
 
 static int string_length = MAXSTRING;
 
+/* Whether 'rh' and 'rt' leave the removed string in the element */
+static int nocopy_mode = 0;
+
+static const char *const backend_names[] = {"list", "ring", NULL};
+
 #define MIN_RANDSTR_LEN 5
 #define MAX_RANDSTR_LEN 10
 static const char charset[] = "abcdefghijklmnopqrstuvwxyz";
@@ -95,9 +100,6 @@ static bool do_free(int argc, char *argv[])
     }
     error_check();
 
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
-
     struct list_head *qnext = NULL;
     if (chain.size > 1) {
         qnext = ((uintptr_t) current->chain.next == (uintptr_t) &chain.head)
@@ -111,7 +113,6 @@ static bool do_free(int argc, char *argv[])
         if (exception_setup(true))
             q_free(current->q);
         exception_cancel();
-        set_cautious_mode(true);
     }
 
     if (current) {
@@ -173,6 +174,91 @@ static void fill_rand_string(char *buf, size_t buf_size)
     buf[len] = '\0';
 }
 
+/* Fill n buffers of MAX_RANDSTR_LEN bytes with random strings, as that many
+ * calls of fill_rand_string() would, but drawing all the random bytes at once.
+ */
+static void fill_rand_strings(char *bufs, int n)
+{
+    randombytes((uint8_t *) bufs, (size_t) n * MAX_RANDSTR_LEN);
+    for (int i = 0; i < n; i++) {
+        uint8_t *buf = (uint8_t *) bufs + (size_t) i * MAX_RANDSTR_LEN;
+        size_t len = 0;
+        while (len < MIN_RANDSTR_LEN)
+            len = rand() % MAX_RANDSTR_LEN;
+
+        for (size_t k = 0; k < len; k++)
+            buf[k] = charset[buf[k] % (sizeof(charset) - 1)];
+        buf[len] = '\0';
+    }
+}
+
+/* Check the copies of the n strings of strs just inserted at the head or the
+ * tail of the current queue, as one insertion at a time checks each of them
+ */
+static bool check_batch(char **strs, int n, bool tail)
+{
+    struct list_head *node = current->q;
+    char *lasts = NULL;
+
+    /* The last string inserted is the nearest to the end */
+    for (int r = n - 1; r >= 0; r--) {
+        node = tail ? q_prev(current->q, node) : q_next(current->q, node);
+        char *cur_inserts = list_entry(node, element_t, list)->value;
+
+        if (!cur_inserts) {
+            report(1, "ERROR: Failed to save copy of string in queue");
+            return false;
+        }
+        if (cur_inserts == strs[r]) {
+            report(1,
+                   "ERROR: Need to allocate and copy string for new queue "
+                   "element");
+            return false;
+        }
+        if (cur_inserts == lasts) {
+            report(1,
+                   "ERROR: Need to allocate separate string for each queue "
+                   "element");
+            return false;
+        }
+        lasts = cur_inserts;
+    }
+    return true;
+}
+
+/* Insert reps copies of inserts, or reps random strings if need_rand, with a
+ * single call of the batch insertion, and check each element inserted. Return
+ * false if the batch could not be inserted, which leaves the queue untouched,
+ * and clear checked if a check failed.
+ */
+static bool insert_batch(char *inserts,
+                         bool need_rand,
+                         int reps,
+                         bool tail,
+                         bool *checked)
+{
+    char **strs = malloc(sizeof(*strs) * reps);
+    char *bufs = need_rand ? malloc((size_t) reps * MAX_RANDSTR_LEN) : NULL;
+    bool ok = strs && (!need_rand || bufs);
+
+    if (ok) {
+        if (need_rand)
+            fill_rand_strings(bufs, reps);
+        for (int r = 0; r < reps; r++)
+            strs[r] = need_rand ? bufs + (size_t) r * MAX_RANDSTR_LEN : inserts;
+        ok = tail ? q_insert_tail_batch(current->q, strs, reps)
+                  : q_insert_head_batch(current->q, strs, reps);
+    }
+    if (ok) {
+        current->size += reps;
+        *checked = check_batch(strs, reps, tail);
+    }
+
+    free(bufs);
+    free(strs);
+    return ok;
+}
+
 /* insert head */
 static bool do_ih(int argc, char *argv[])
 {
@@ -218,14 +304,21 @@ static bool do_ih(int argc, char *argv[])
     error_check();
 
     if (current && exception_setup(true)) {
-        for (int r = 0; ok && r < reps; r++) {
+        int r = 0;
+        /* Insert a count at once, falling back to one at a time on failure */
+        if (reps > 1 && insert_batch(inserts, need_rand, reps, false, &ok)) {
+            r = reps;
+            ok = ok && !error_check();
+        }
+        for (; ok && r < reps; r++) {
             if (need_rand)
                 fill_rand_string(randstr_buf, sizeof(randstr_buf));
             bool rval = q_insert_head(current->q, inserts);
             if (rval) {
                 current->size++;
                 char *cur_inserts =
-                    list_entry(current->q->next, element_t, list)->value;
+                    list_entry(q_next(current->q, current->q), element_t, list)
+                        ->value;
                 if (!cur_inserts) {
                     report(1, "ERROR: Failed to save copy of string in queue");
                     ok = false;
@@ -307,14 +400,21 @@ static bool do_it(int argc, char *argv[])
     error_check();
 
     if (current && exception_setup(true)) {
-        for (int r = 0; ok && r < reps; r++) {
+        int r = 0;
+        /* Insert a count at once, falling back to one at a time on failure */
+        if (reps > 1 && insert_batch(inserts, need_rand, reps, true, &ok)) {
+            r = reps;
+            ok = ok && !error_check();
+        }
+        for (; ok && r < reps; r++) {
             if (need_rand)
                 fill_rand_string(randstr_buf, sizeof(randstr_buf));
             bool rval = q_insert_tail(current->q, inserts);
             if (rval) {
                 current->size++;
                 char *cur_inserts =
-                    list_entry(current->q->prev, element_t, list)->value;
+                    list_entry(q_prev(current->q, current->q), element_t, list)
+                        ->value;
                 if (!cur_inserts) {
                     report(1, "ERROR: Failed to save copy of string in queue");
                     ok = false;
@@ -338,6 +438,152 @@ static bool do_it(int argc, char *argv[])
     return ok;
 }
 
+static bool do_is(int argc, char *argv[])
+{
+    char randstr_buf[MAX_RANDSTR_LEN];
+    int reps = 1;
+    bool ok = true, need_rand = false;
+    if (argc != 2 && argc != 3) {
+        report(1, "%s needs 1-2 arguments", argv[0]);
+        return false;
+    }
+
+    char *inserts = argv[1];
+    if (argc == 3) {
+        if (!get_int(argv[2], &reps)) {
+            report(1, "Invalid number of insertions '%s'", argv[2]);
+            return false;
+        }
+    }
+
+    if (!strcmp(inserts, "RAND")) {
+        need_rand = true;
+        inserts = randstr_buf;
+    }
+
+    if (!current || !current->q)
+        report(3, "Warning: Calling insert sorted on null queue");
+    error_check();
+
+    if (current && exception_setup(true)) {
+        for (int r = 0; ok && r < reps; r++) {
+            if (need_rand)
+                fill_rand_string(randstr_buf, sizeof(randstr_buf));
+            bool rval = q_insert_sorted(current->q, inserts);
+            if (rval) {
+                current->size++;
+            } else {
+                fail_count++;
+                if (fail_count < fail_limit)
+                    report(2, "Insertion of %s failed", inserts);
+                else {
+                    report(1,
+                           "ERROR: Insertion of %s failed (%d failures total)",
+                           inserts, fail_count);
+                    ok = false;
+                }
+            }
+            ok = ok && !error_check();
+        }
+    }
+    exception_cancel();
+    q_show(3);
+    return ok;
+}
+
+/* Check a string removed by 'rh str n' or 'rt str n' against str, where "*"
+ * matches any string
+ */
+static bool check_removed(const char *removed, const char *checks)
+{
+    if (strcmp(checks, "*") && strcmp(removed, checks)) {
+        report(1, "ERROR: Removed value %s != expected value %s", removed,
+               checks);
+        return false;
+    }
+    report(2, "Removed %s from queue", removed);
+    return true;
+}
+
+/* Remove n elements at once. The strings are drained into a buffer with room
+ * for n strings of the displayed length; the elements whose strings do not fit
+ * are cut off onto a list instead.
+ */
+static bool do_remove_n(int option, char *checks, int reps)
+{
+    size_t bufsize = (size_t) reps * (string_length + 1);
+    char *removes = malloc(bufsize + STRINGPAD);
+    size_t *offsets = malloc(sizeof(*offsets) * reps);
+    LIST_HEAD(list);
+    int cnt = 0, rest = 0;
+    bool ok = true;
+
+    if (!removes || !offsets) {
+        report(1,
+               "INTERNAL ERROR.  Could not allocate space for removed strings");
+        free(removes);
+        free(offsets);
+        return false;
+    }
+    memset(removes + bufsize, 'X', STRINGPAD);
+
+    if (!current || !current->size)
+        report(3, "Warning: Calling remove head on empty queue");
+    error_check();
+
+    if (current && exception_setup(true)) {
+        cnt = option ? q_remove_tail_copy(current->q, reps, removes, bufsize,
+                                          offsets)
+                     : q_remove_head_copy(current->q, reps, removes, bufsize,
+                                          offsets);
+        rest = option ? q_remove_tail_n(current->q, reps - cnt, &list)
+                      : q_remove_head_n(current->q, reps - cnt, &list);
+    }
+    exception_cancel();
+
+    int i = 0;
+    while (i < STRINGPAD && removes[bufsize + i] == 'X')
+        i++;
+    if (i != STRINGPAD) {
+        report(1,
+               "ERROR: copying of strings in remove overflowed destination "
+               "buffer.");
+        ok = false;
+    }
+
+    /* The strings are in queue order, whichever end they came from */
+    for (i = 0; ok && i < cnt; i++)
+        ok = check_removed(removes + offsets[i], checks);
+
+    element_t *item = NULL, *tmp = NULL;
+    list_for_each_entry_safe (item, tmp, &list, list) {
+        ok = ok && check_removed(item->value, checks);
+        q_release_element(item);
+    }
+
+    if (current)
+        current->size -= cnt + rest;
+    if (cnt + rest < reps) {
+        fail_count++;
+        if (fail_count < fail_limit) {
+            report(2, "Removal of %d elements from queue stopped after %d",
+                   reps, cnt + rest);
+        } else {
+            report(1,
+                   "ERROR: Removal of %d elements from queue stopped after %d "
+                   "(%d failures total)",
+                   reps, cnt + rest, fail_count);
+            ok = false;
+        }
+    }
+
+    q_show(3);
+
+    free(removes);
+    free(offsets);
+    return ok && !error_check();
+}
+
 static bool do_remove(int option, int argc, char *argv[])
 {
     // option 0 is for remove head; option 1 is for remove tail
@@ -363,11 +609,20 @@ static bool do_remove(int option, int argc, char *argv[])
     }
 #endif
 
-    if (argc != 1 && argc != 2) {
-        report(1, "%s needs 0-1 arguments", argv[0]);
+    if (argc != 1 && argc != 2 && argc != 3) {
+        report(1, "%s needs 0-2 arguments", argv[0]);
         return false;
     }
 
+    if (argc == 3) {
+        int reps = 0;
+        if (!get_int(argv[2], &reps) || reps <= 0) {
+            report(1, "Invalid number of removals '%s'", argv[2]);
+            return false;
+        }
+        return do_remove_n(option, argv[1], reps);
+    }
+
     char *removes = malloc(string_length + STRINGPAD + 1);
     if (!removes) {
         report(1,
@@ -398,21 +653,21 @@ static bool do_remove(int option, int argc, char *argv[])
         report(3, "Warning: Calling remove head on empty queue");
     error_check();
 
+    /* Without a buffer, the string is only looked at in the element */
+    char *sp = nocopy_mode ? NULL : removes;
+    size_t bufsize = nocopy_mode ? 0 : string_length + 1;
     element_t *re = NULL;
     if (current && exception_setup(true))
-        re = option ? q_remove_tail(current->q, removes, string_length + 1)
-                    : q_remove_head(current->q, removes, string_length + 1);
+        re = option ? q_remove_tail(current->q, sp, bufsize)
+                    : q_remove_head(current->q, sp, bufsize);
     exception_cancel();
 
     bool is_null = re ? false : true;
+    const char *removed = nocopy_mode && re ? re->value : removes;
 
     if (!is_null) {
-        // q_remove_head and q_remove_tail are not responsible for releasing
-        // node
-        q_release_element(re);
-
         removes[string_length + STRINGPAD] = '\0';
-        if (removes[0] == '\0') {
+        if (!removed || removed[0] == '\0') {
             report(1, "ERROR: Failed to store removed value");
             ok = false;
         }
@@ -428,8 +683,8 @@ static bool do_remove(int option, int argc, char *argv[])
                    "ERROR: copying of string in remove_head overflowed "
                    "destination buffer.");
             ok = false;
-        } else {
-            report(2, "Removed %s from queue", removes);
+        } else if (ok) {
+            report(2, "Removed %.*s from queue", string_length, removed);
         }
         current->size--;
     } else {
@@ -443,12 +698,16 @@ static bool do_remove(int option, int argc, char *argv[])
         }
     }
 
-    if (ok && check && strcmp(removes, checks)) {
-        report(1, "ERROR: Removed value %s != expected value %s", removes,
-               checks);
+    if (ok && check && strncmp(removed, checks, string_length)) {
+        report(1, "ERROR: Removed value %.*s != expected value %s",
+               string_length, removed, checks);
         ok = false;
     }
 
+    // q_remove_head and q_remove_tail are not responsible for releasing node
+    if (re)
+        q_release_element(re);
+
     q_show(3);
 
     free(removes);
@@ -466,18 +725,66 @@ static inline bool do_rt(int argc, char *argv[])
     return do_remove(1, argc, argv);
 }
 
+/* String of a copied element and its position in the queue */
+struct dup_item {
+    const char *value;
+    size_t pos;
+};
+
+static int dup_cmp(const void *a, const void *b)
+{
+    return strcmp(((const struct dup_item *) a)->value,
+                  ((const struct dup_item *) b)->value);
+}
+
+/* Return an array which tells for each position of list whether its string
+ * occurs more than once, or NULL if it could not be allocated
+ */
+static bool *find_dups(struct list_head *list)
+{
+    size_t n = 0, i = 0;
+    element_t *item = NULL;
+
+    list_for_each_entry (item, list, list)
+        n++;
+    struct dup_item *items = malloc(n * sizeof(*items));
+    bool *dups = calloc(n, sizeof(*dups));
+    if (!items || !dups) {
+        free(items);
+        free(dups);
+        return NULL;
+    }
+
+    list_for_each_entry (item, list, list) {
+        items[i].value = item->value;
+        items[i].pos = i;
+        i++;
+    }
+    qsort(items, n, sizeof(*items), dup_cmp);
+    for (i = 1; i < n; i++) {
+        if (strcmp(items[i - 1].value, items[i].value) == 0)
+            dups[items[i - 1].pos] = dups[items[i].pos] = true;
+    }
+
+    free(items);
+    return dups;
+}
+
 static bool do_dedup(int argc, char *argv[])
 {
-    if (argc != 1) {
-        report(1, "%s takes no arguments", argv[0]);
+    bool unsorted = argc == 2 && strcmp(argv[1], "unsorted") == 0;
+    if (argc != 1 && !unsorted) {
+        report(1, "%s takes no arguments, or 'unsorted'", argv[0]);
         return false;
     }
 
     LIST_HEAD(l_copy);
     element_t *item = NULL, *tmp = NULL;
+    bool *dups = NULL;
 
-    // Copy current->q to l_copy
+    // Copy current->q to l_copy, which is compared against it in order
     if (current->q && !list_empty(current->q)) {
+        q_sync(current->q);
         list_for_each_entry (item, current->q, list) {
             size_t slen;
             tmp = malloc(sizeof(element_t));
@@ -494,7 +801,8 @@ static bool do_dedup(int argc, char *argv[])
             list_add_tail(&tmp->list, &l_copy);
         }
         // Return false if the loop does not leave properly
-        if (&item->list != current->q) {
+        if (&item->list != current->q ||
+            (unsorted && !(dups = find_dups(&l_copy)))) {
             list_for_each_entry_safe (item, tmp, &l_copy, list) {
                 free(item->value);
                 free(item);
@@ -508,7 +816,8 @@ static bool do_dedup(int argc, char *argv[])
 
     bool ok = true;
     if (exception_setup(true))
-        ok = q_delete_dup(current->q);
+        ok = unsorted ? q_delete_dup_unsorted(current->q)
+                      : q_delete_dup(current->q);
     exception_cancel();
 
     if (!ok) {
@@ -516,12 +825,14 @@ static bool do_dedup(int argc, char *argv[])
             free(item->value);
             free(item);
         }
+        free(dups);
         report(1, "ERROR: Calling delete duplicate on null queue");
         return false;
     }
 
     struct list_head *l_tmp = current->q->next;
     bool is_this_dup = false;
+    size_t pos = 0;
     // Compare between new list and old one
     list_for_each_entry (item, &l_copy, list) {
         // Skip comparison with new list if the string is duplicate
@@ -529,7 +840,7 @@ static bool do_dedup(int argc, char *argv[])
             item->list.next != &l_copy &&
             strcmp(list_entry(item->list.next, element_t, list)->value,
                    item->value) == 0;
-        if (is_this_dup || is_next_dup) {
+        if (unsorted ? dups[pos++] : is_this_dup || is_next_dup) {
             // Update list size
             current->size--;
         } else if (l_tmp != current->q &&
@@ -551,6 +862,7 @@ static bool do_dedup(int argc, char *argv[])
         free(item->value);
         free(item);
     }
+    free(dups);
 
     q_show(3);
     return ok && !error_check();
@@ -625,6 +937,125 @@ static bool do_size(int argc, char *argv[])
     return ok && !error_check();
 }
 
+/* Position of the first element of the current queue equal to s, found by
+ * walking it, -1 for none
+ */
+static int find_by_walk(const char *s)
+{
+    struct list_head *head = current->q;
+    int pos = 0;
+
+    for (struct list_head *iter = q_next(head, head); iter != head;
+         iter = q_next(head, iter), pos++) {
+        if (!strcmp(list_entry(iter, element_t, list)->value, s))
+            return pos;
+    }
+    return -1;
+}
+
+static bool do_find(int argc, char *argv[])
+{
+    int reps = 1;
+    bool ok = true;
+    if (argc != 2 && argc != 3) {
+        report(1, "%s needs 1-2 arguments", argv[0]);
+        return false;
+    }
+
+    if (argc == 3) {
+        if (!get_int(argv[2], &reps)) {
+            report(1, "Invalid number of calls to find '%s'", argv[2]);
+            return false;
+        }
+    }
+
+    int pos = -1;
+    if (!current || !current->q)
+        report(3, "Warning: Calling find on null queue");
+    error_check();
+
+    if (current && exception_setup(true)) {
+        for (int r = 0; ok && r < reps; r++) {
+            pos = q_find(current->q, argv[1]);
+            ok = ok && !error_check();
+        }
+    }
+    exception_cancel();
+
+    if (current && current->q && ok) {
+        int expected = find_by_walk(argv[1]);
+        if (pos != expected) {
+            report(1, "ERROR: Found %s at position %d, but it is first at %d",
+                   argv[1], pos, expected);
+            ok = false;
+        } else if (pos < 0) {
+            report(2, "%s not found", argv[1]);
+        } else {
+            report(2, "Found %s at position %d", argv[1], pos);
+        }
+    }
+
+    q_show(3);
+    return ok && !error_check();
+}
+
+static bool do_nth(int argc, char *argv[])
+{
+    int k = 0, reps = 1;
+    bool ok = true;
+    if (argc != 2 && argc != 3) {
+        report(1, "%s needs 1-2 arguments", argv[0]);
+        return false;
+    }
+
+    if (!get_int(argv[1], &k)) {
+        report(1, "Invalid position '%s'", argv[1]);
+        return false;
+    }
+    if (argc == 3) {
+        if (!get_int(argv[2], &reps)) {
+            report(1, "Invalid number of calls to nth '%s'", argv[2]);
+            return false;
+        }
+    }
+
+    element_t *e = NULL;
+    if (!current || !current->q)
+        report(3, "Warning: Calling nth on null queue");
+    error_check();
+
+    if (current && exception_setup(true)) {
+        for (int r = 0; ok && r < reps; r++) {
+            e = q_nth(current->q, k);
+            ok = ok && !error_check();
+        }
+    }
+    exception_cancel();
+
+    if (current && current->q && ok) {
+        struct list_head *head = current->q, *iter = q_next(head, head);
+        for (int i = 0; i < k && iter != head; i++)
+            iter = q_next(head, iter);
+        element_t *expected = (k < 0 || iter == head)
+                                  ? NULL
+                                  : list_entry(iter, element_t, list);
+
+        if (e != expected) {
+            report(1, "ERROR: Element at position %d is %s, but should be %s",
+                   k, e ? e->value : "NULL",
+                   expected ? expected->value : "NULL");
+            ok = false;
+        } else if (e == NULL) {
+            report(2, "No element at position %d", k);
+        } else {
+            report(2, "Element at position %d is %s", k, e->value);
+        }
+    }
+
+    q_show(3);
+    return ok && !error_check();
+}
+
 bool do_sort(int argc, char *argv[])
 {
     if (argc != 1) {
@@ -651,13 +1082,15 @@ bool do_sort(int argc, char *argv[])
 
     bool ok = true;
     if (current && current->size) {
-        for (struct list_head *cur_l = current->q->next;
-             cur_l != current->q && --cnt; cur_l = cur_l->next) {
+        /* A presorted queue may be left reversed rather than relinked */
+        for (struct list_head *cur_l = q_next(current->q, current->q);
+             cur_l != current->q && --cnt;
+             cur_l = q_next(current->q, cur_l)) {
             /* Ensure each element in ascending order */
             /* FIXME: add an option to specify sorting order */
             element_t *item, *next_item;
             item = list_entry(cur_l, element_t, list);
-            next_item = list_entry(cur_l->next, element_t, list);
+            next_item = list_entry(q_next(current->q, cur_l), element_t, list);
             if (strcmp(item->value, next_item->value) > 0) {
                 report(1, "ERROR: Not sorted in ascending order");
                 ok = false;
@@ -672,6 +1105,21 @@ bool do_sort(int argc, char *argv[])
 
 static bool do_dm(int argc, char *argv[])
 {
+    if (simulation) {
+        if (argc != 1) {
+            report(1, "%s does not need arguments in simulation mode", argv[0]);
+            return false;
+        }
+        bool ok = is_delete_mid_const();
+        if (!ok) {
+            report(1,
+                   "ERROR: Probably not constant time or wrong implementation");
+            return false;
+        }
+        report(1, "Probably constant time");
+        return ok;
+    }
+
     if (argc != 1) {
         report(1, "%s takes no arguments", argv[0]);
         return false;
@@ -808,7 +1256,7 @@ static bool do_merge(int argc, char *argv[])
     exception_cancel();
     set_noallocate_mode(false);
 
-    if (q_size(&chain.head) > 1) {
+    if (chain.size > 1) {
         chain.size = 1;
         current = list_entry(chain.head.next, queue_contex_t, chain);
         current->size = len;
@@ -848,6 +1296,96 @@ static bool do_merge(int argc, char *argv[])
     return ok && !error_check();
 }
 
+static bool do_allocs(int argc, char *argv[])
+{
+    int limit = 10;
+
+    if (argc > 2) {
+        report(1, "%s takes 0-1 arguments", argv[0]);
+        return false;
+    }
+
+    if (argc == 2 && (!get_int(argv[1], &limit) || limit <= 0)) {
+        report(1, "Invalid number of allocation sites '%s'", argv[1]);
+        return false;
+    }
+
+    if (!allocprof_mode)
+        report(3, "Warning: Allocation profiling is off");
+
+    allocprof_report(limit);
+    return true;
+}
+
+static bool do_stress(int argc, char *argv[])
+{
+    int args[3] = {0, 0, 0};
+
+    if (argc > 4) {
+        report(1, "%s takes 0-3 arguments", argv[0]);
+        return false;
+    }
+
+    for (int i = 1; i < argc; i++) {
+        if (!get_int(argv[i], &args[i - 1]) || args[i - 1] <= 0) {
+            report(1, "Invalid argument '%s'", argv[i]);
+            return false;
+        }
+    }
+
+    /* As many consumers as producers unless given */
+    if (argc == 2)
+        args[1] = args[0];
+
+    bool ok = false;
+    if (exception_setup(false))
+        ok = bench_stress(args[0], args[1], args[2]);
+    exception_cancel();
+
+    return ok && !error_check();
+}
+
+static bool do_bench(int argc, char *argv[])
+{
+    int n = 0;
+
+    if (argc != 2 && argc != 3) {
+        report(1, "%s takes 1-2 arguments", argv[0]);
+        return false;
+    }
+
+    if (argc == 3 && (!get_int(argv[2], &n) || n <= 0)) {
+        report(1, "Invalid number of elements '%s'", argv[2]);
+        return false;
+    }
+
+    bool (*bench)(int n) = NULL;
+    if (strcmp(argv[1], "sort") == 0)
+        bench = bench_sort;
+    else if (strcmp(argv[1], "merge") == 0)
+        bench = bench_merge;
+    else if (strcmp(argv[1], "dedup") == 0)
+        bench = bench_dedup;
+    else if (strcmp(argv[1], "remove") == 0)
+        bench = bench_remove;
+    else if (strcmp(argv[1], "backend") == 0)
+        bench = bench_backend;
+    else if (strcmp(argv[1], "reverseK") == 0)
+        bench = bench_reverseK;
+    else {
+        report(1, "Unknown benchmark '%s'", argv[1]);
+        return false;
+    }
+
+    /* Benchmarks may take longer than the time limit of a single operation */
+    bool ok = false;
+    if (exception_setup(false))
+        ok = bench(n);
+    exception_cancel();
+
+    return ok && !error_check();
+}
+
 static bool is_circular()
 {
     struct list_head *cur = current->q->next;
@@ -886,7 +1424,7 @@ static bool q_show(int vlevel)
     report_noreturn(vlevel, "l = [");
 
     struct list_head *ori = current->q;
-    struct list_head *cur = current->q->next;
+    struct list_head *cur = q_next(ori, ori);
 
     if (exception_setup(true)) {
         while (ok && ori != cur && cnt < current->size) {
@@ -900,7 +1438,7 @@ static bool q_show(int vlevel)
                 }
             }
             cnt++;
-            cur = cur->next;
+            cur = q_next(ori, cur);
             ok = ok && !error_check();
         }
     }
@@ -999,20 +1537,32 @@ static void console_init()
                 "Insert string str at tail of queue n times. Generate random "
                 "string(s) if str equals RAND. (default: n == 1)",
                 "str [n]");
-    ADD_COMMAND(
-        rh,
-        "Remove from head of queue. Optionally compare to expected value str",
-        "[str]");
-    ADD_COMMAND(
-        rt,
-        "Remove from tail of queue. Optionally compare to expected value str",
-        "[str]");
+    ADD_COMMAND(is,
+                "Insert string str n times into sorted queue, keeping it "
+                "sorted. Generate random string(s) if str equals RAND. "
+                "(default: n == 1)",
+                "str [n]");
+    ADD_COMMAND(rh,
+                "Remove from head of queue n times at once. Optionally compare "
+                "to expected value str, where * matches any (default: n == 1)",
+                "[str [n]]");
+    ADD_COMMAND(rt,
+                "Remove from tail of queue n times at once. Optionally compare "
+                "to expected value str, where * matches any (default: n == 1)",
+                "[str [n]]");
     ADD_COMMAND(reverse, "Reverse queue", "");
     ADD_COMMAND(sort, "Sort queue in ascending order", "");
     ADD_COMMAND(size, "Compute queue size n times (default: n == 1)", "[n]");
+    ADD_COMMAND(find,
+                "Find the position of the first element with string str n "
+                "times (default: n == 1)",
+                "str [n]");
+    ADD_COMMAND(nth, "Get the element at position k n times (default: n == 1)",
+                "k [n]");
     ADD_COMMAND(show, "Show queue contents", "");
     ADD_COMMAND(dm, "Delete middle node in queue", "");
-    ADD_COMMAND(dedup, "Delete all nodes that have duplicate string", "");
+    ADD_COMMAND(dedup, "Delete all nodes that have duplicate string",
+                "[unsorted]");
     ADD_COMMAND(merge, "Merge all the queues into one sorted queue", "");
     ADD_COMMAND(swap, "Swap every two adjacent nodes in queue", "");
     ADD_COMMAND(descend,
@@ -1021,12 +1571,53 @@ static void console_init()
                 "");
     ADD_COMMAND(reverseK, "Reverse the nodes of the queue 'K' at a time",
                 "[K]");
+    ADD_COMMAND(allocs,
+                "Show the n call sites which allocated most bytes "
+                "(default: n == 10)",
+                "[n]");
+    ADD_COMMAND(bench,
+                "Run benchmark 'sort' (default: n == 1M), 'merge' "
+                "(default: 1M, 4M and 16M), 'dedup' (default: 10M), "
+                "'remove' (default: 1M), 'backend' (default: 1M) or "
+                "'reverseK' (default: 1M) on n random strings",
+                "sort|merge|dedup|remove|backend|reverseK [n]");
+    ADD_COMMAND(stress,
+                "Pass n elements (default: 100K) from each of p producer "
+                "threads to c consumer threads (default: p) through a "
+                "concurrent queue, by default with 1, 2 and 4 threads each",
+                "[p [c [n]]]");
     add_param("length", &string_length, "Maximum length of displayed string",
               NULL);
     add_param("malloc", &fail_probability, "Malloc failure probability percent",
               NULL);
     add_param("fail", &fail_limit,
               "Number of times allow queue operations to return false", NULL);
+    add_param("allocprof", &allocprof_mode,
+              "Record allocations per call site, see 'allocs'", NULL);
+    add_param("slab", &q_slab_mode,
+              "Carve elements of new queues out of per-queue slabs", NULL);
+    add_param_names("backend", &q_backend, backend_names,
+                    "Storage of elements of new queues", NULL);
+    add_param("prefix", &q_prefix_mode,
+              "Compare elements by their cached 8-byte prefix first", NULL);
+    add_param("radix", &q_radix_min,
+              "Radix sort queues of at least this size (0: never)", NULL);
+    add_param("threads", &q_sort_threads,
+              "Number of threads to split large sorts across", NULL);
+    add_param("mid", &q_mid_mode,
+              "Track the middle node of queues for constant time 'dm'", NULL);
+    add_param("lazyrev", &q_lazy_reverse,
+              "Reverse queues in constant time, relinking nodes when needed",
+              NULL);
+    add_param("ktail", &q_ktail_mode,
+              "Also reverse the last group of 'reverseK' when it is short",
+              NULL);
+    add_param("skip", &q_skip_min,
+              "Index queues of at least this size for 'is' (0: never)", NULL);
+    add_param("index", &q_index_mode,
+              "Keep a search index of queues for 'find' and 'nth'", NULL);
+    add_param("nocopy", &nocopy_mode,
+              "Remove with 'rh' and 'rt' without copying the string out", NULL);
 }
 
 /* Signal handlers */
@@ -1059,8 +1650,6 @@ static void q_init()
 static bool q_quit(int argc, char *argv[])
 {
     report(3, "Freeing queue");
-    if (current && current->size > BIG_LIST_SIZE)
-        set_cautious_mode(false);
 
     if (exception_setup(true)) {
         struct list_head *cur = chain.head.next;
@@ -1075,7 +1664,6 @@ static bool q_quit(int argc, char *argv[])
     }
 
     exception_cancel();
-    set_cautious_mode(true);
 
     size_t bcnt = allocation_check();
     if (bcnt > 0) {
@@ -9,6 +9,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #include "harness.h"
 #include "list.h"
@@ -17,14 +18,43 @@
  * element_t - Linked list element
  * @value: pointer to array holding string
  * @list: node of a doubly-linked list
+ * @key: first 8 bytes of @value, big-endian and zero-padded
+ * @flags: ELEMENT_* bits describing how the element was allocated and
+ * whether it is indexed
+ * @inline_value: storage for a string allocated together with the element
  *
- * @value needs to be explicitly allocated and freed
+ * @value needs to be explicitly allocated and freed, unless it points to
+ * @inline_value. Short strings are kept inline, so that comparing them does
+ * not touch another cache line.
+ *
+ * @key is computed when the element is inserted. Comparing the keys as
+ * integers orders elements the same way as strcmp() on their first 8 bytes.
  */
 typedef struct {
     char *value;
     struct list_head list;
+    uint64_t key;
+    unsigned int flags;
+    char inline_value[];
 } element_t;
 
+/* The element is carved out of a queue slab and released by q_free() */
+#define ELEMENT_SLAB 0x1
+
+/* The element sits in a slot of a ring-backed queue, which reuses the slot
+ * once it is released and marked ELEMENT_FREE
+ */
+#define ELEMENT_RING 0x2
+#define ELEMENT_FREE 0x4
+
+/* The element may have a tower in the skip-list index of its queue */
+#define ELEMENT_INDEXED 0x8
+
+/* The element shares a block with others built by the same batch insertion,
+ * which is freed once all of them are released
+ */
+#define ELEMENT_BATCH 0x10
+
 /**
  * queue_contex_t - The context managing a chain of queues
  * @q: pointer to the head of the queue
@@ -39,6 +69,58 @@ typedef struct {
     int id;
 } queue_contex_t;
 
+/* Tunables, exposed as options of qtest */
+
+/* Nonzero to carve the elements of newly created queues out of slabs */
+extern int q_slab_mode;
+
+/* Storage of the elements of newly created queues: separate allocations, or
+ * consecutive slots of a ring of blocks which grows and shrinks at both ends
+ */
+enum { Q_BACKEND_LIST, Q_BACKEND_RING };
+extern int q_backend;
+
+/* Nonzero to compare elements by their cached key before their strings */
+extern int q_prefix_mode;
+
+/* Queues of at least this many elements are radix sorted, 0 to disable */
+extern int q_radix_min;
+
+/* Number of threads q_sort() may split large queues across */
+extern int q_sort_threads;
+
+/* Nonzero to track the middle node of queues, so that q_delete_mid() takes
+ * amortized constant time
+ */
+extern int q_mid_mode;
+
+/* Nonzero for q_reverse() to only flip a direction flag of the queue, leaving
+ * the nodes to be relinked by the first operation which needs them in order
+ */
+extern int q_lazy_reverse;
+
+/* Nonzero for q_reverseK() to also reverse the last group, when fewer than k
+ * nodes are left for it
+ */
+extern int q_ktail_mode;
+
+/* Queues of at least this many elements get a skip-list index for
+ * q_insert_sorted(), 0 to disable
+ */
+extern int q_skip_min;
+
+/* Nonzero for q_find() and q_nth() to keep a search index of queues, 0 for
+ * them to walk the queue
+ */
+extern int q_index_mode;
+
+/* Statistics */
+
+/* Number of element comparisons done by the queue operations called from this
+ * thread
+ */
+extern _Thread_local unsigned long q_compare_count;
+
 /* Operations on queue */
 
 /**
@@ -51,6 +133,9 @@ struct list_head *q_new();
 /**
  * q_free() - Free all storage used by queue, no effect if header is NULL
  * @head: header of queue
+ *
+ * This also releases the slabs of the queue, including the storage of
+ * elements that were removed from it but not yet released.
  */
 void q_free(struct list_head *head);
 
@@ -78,6 +163,55 @@ bool q_insert_head(struct list_head *head, char *s);
  */
 bool q_insert_tail(struct list_head *head, char *s);
 
+/**
+ * q_insert_head_batch() - Insert n elements at the head
+ * @head: header of queue
+ * @strs: strings would be inserted
+ * @n: number of strings
+ *
+ * The queue ends up as after calling q_insert_head() on strs[0] to strs[n - 1]
+ * in turn, so strs[n - 1] is the new head. All elements are built before any
+ * is linked in, and the queue is only changed if every one of them could be.
+ *
+ * Return: true for success, false for allocation failed, a NULL string or
+ * queue is NULL
+ */
+bool q_insert_head_batch(struct list_head *head, char **strs, size_t n);
+
+/**
+ * q_insert_tail_batch() - Insert n elements at the tail
+ * @head: header of queue
+ * @strs: strings would be inserted
+ * @n: number of strings
+ *
+ * The queue ends up as after calling q_insert_tail() on strs[0] to strs[n - 1]
+ * in turn. All elements are built before any is linked in, and the queue is
+ * only changed if every one of them could be.
+ *
+ * Return: true for success, false for allocation failed, a NULL string or
+ * queue is NULL
+ */
+bool q_insert_tail_batch(struct list_head *head, char **strs, size_t n);
+
+/**
+ * q_insert_sorted() - Insert an element into a sorted queue
+ * @head: header of queue
+ * @s: string would be inserted
+ *
+ * The element goes before the first element greater than @s, so that a queue
+ * sorted in ascending order stays sorted, after any elements equal to @s.
+ * Large queues keep a skip-list index over some of their nodes to find the
+ * place in expected O(log n) time. It is dropped by operations which remove
+ * indexed nodes other than the first or which rearrange the queue, and
+ * rebuilt by the next call.
+ *
+ * Argument s points to the string to be stored.
+ * The function must explicitly allocate space and copy the string into it.
+ *
+ * Return: true for success, false for allocation failed or queue is NULL
+ */
+bool q_insert_sorted(struct list_head *head, char *s);
+
 /**
  * q_remove_head() - Remove the element from head of queue
  * @head: header of queue
@@ -86,6 +220,8 @@ bool q_insert_tail(struct list_head *head, char *s);
  *
  * If sp is non-NULL and an element is removed, copy the removed string to *sp
  * (up to a maximum of bufsize-1 characters, plus a null terminator.)
+ * Callers which only need the element pass a NULL sp, and the string is left
+ * in place without any copy.
  *
  * NOTE: "remove" is different from "delete"
  * The space used by the list element and the string should not be freed.
@@ -104,20 +240,117 @@ element_t *q_remove_head(struct list_head *head, char *sp, size_t bufsize);
  * @sp: string would be inserted
  * @bufsize: size of the string
  *
+ * The string is copied to sp as in q_remove_head(), or not at all if sp is
+ * NULL.
+ *
  * Return: the pointer to element, %NULL if queue is NULL or empty.
  */
 element_t *q_remove_tail(struct list_head *head, char *sp, size_t bufsize);
 
+/**
+ * q_remove_head_n() - Remove up to k elements from head of queue
+ * @head: header of queue
+ * @k: number of elements to remove
+ * @list: list the removed elements are appended to
+ *
+ * The elements are cut off as one segment and keep their queue order on list,
+ * so the work is O(k) pointer updates and no string is copied. As with
+ * q_remove_head(), the caller is responsible for releasing them.
+ *
+ * Return: the number of elements removed, fewer than k if queue is shorter,
+ * 0 if queue or list is NULL.
+ */
+int q_remove_head_n(struct list_head *head, int k, struct list_head *list);
+
+/**
+ * q_remove_tail_n() - Remove up to k elements from tail of queue
+ * @head: header of queue
+ * @k: number of elements to remove
+ * @list: list the removed elements are appended to
+ *
+ * Like q_remove_head_n(), the removed elements keep their queue order, so the
+ * former tail of queue ends up at the tail of list.
+ *
+ * Return: the number of elements removed, fewer than k if queue is shorter,
+ * 0 if queue or list is NULL.
+ */
+int q_remove_tail_n(struct list_head *head, int k, struct list_head *list);
+
+/**
+ * q_remove_head_copy() - Remove up to k elements from head of queue into a
+ *                        buffer
+ * @head: header of queue
+ * @k: number of elements to remove
+ * @buf: buffer the strings are packed into
+ * @bufsize: size of buf
+ * @offsets: array of at least k entries for the offsets of the strings
+ *
+ * Remove elements while both k and buf allow, copying each string with its
+ * null terminator to buf, right after the previous one, and its offset to
+ * offsets. Unlike q_remove_head(), strings are never truncated, and the
+ * removed elements are released here.
+ *
+ * Return: the number of elements removed, fewer than k if queue is shorter or
+ * buf is full, 0 if queue, buf or offsets is NULL.
+ */
+int q_remove_head_copy(struct list_head *head,
+                       int k,
+                       char *buf,
+                       size_t bufsize,
+                       size_t *offsets);
+
+/**
+ * q_remove_tail_copy() - Remove up to k elements from tail of queue into a
+ *                        buffer
+ * @head: header of queue
+ * @k: number of elements to remove
+ * @buf: buffer the strings are packed into
+ * @bufsize: size of buf
+ * @offsets: array of at least k entries for the offsets of the strings
+ *
+ * Like q_remove_head_copy(), the strings are packed in queue order, so the
+ * string of the former tail of queue comes last.
+ *
+ * Return: the number of elements removed, fewer than k if queue is shorter or
+ * buf is full, 0 if queue, buf or offsets is NULL.
+ */
+int q_remove_tail_copy(struct list_head *head,
+                       int k,
+                       char *buf,
+                       size_t bufsize,
+                       size_t *offsets);
+
+/**
+ * q_release_batch_element() - Release an element built by a batch insertion
+ * @e: element would be released
+ *
+ * The block holding the element is freed together with the last of its
+ * elements.
+ *
+ * This function is intended for internal use only.
+ */
+void q_release_batch_element(element_t *e);
+
 /**
  * q_release_element() - Release the element
  * @e: element would be released
  *
+ * Elements carved out of a slab stay valid until their queue is freed, so
+ * only their separately allocated string is released here. Elements in a ring
+ * slot are only marked, and their queue takes the slot back later.
+ *
  * This function is intended for internal use only.
  */
 static inline void q_release_element(element_t *e)
 {
-    test_free(e->value);
-    test_free(e);
+    if (e->value != e->inline_value)
+        test_free(e->value);
+    if (e->flags & ELEMENT_RING)
+        e->flags |= ELEMENT_FREE;
+    else if (e->flags & ELEMENT_BATCH)
+        q_release_batch_element(e);
+    else if (!(e->flags & ELEMENT_SLAB))
+        test_free(e);
 }
 
 /**
@@ -128,6 +361,32 @@ static inline void q_release_element(element_t *e)
  */
 int q_size(struct list_head *head);
 
+/**
+ * q_find() - Find the first element of queue with a given string
+ * @head: header of queue
+ * @s: string to look for
+ *
+ * The first call builds a search index of the queue in linear time. Queries
+ * then take constant time as long as the queue only changes at its ends; any
+ * other change makes the next query build the index anew.
+ *
+ * Return: the 0-based position of the element from the head of queue, -1 if
+ * no element has string @s or queue is NULL
+ */
+int q_find(struct list_head *head, const char *s);
+
+/**
+ * q_nth() - Get the element at a given position of queue
+ * @head: header of queue
+ * @k: 0-based position from the head of queue
+ *
+ * Uses the search index of q_find(), building it if needed.
+ *
+ * Return: the element, still in queue, or NULL if @k is out of range or
+ * queue is NULL
+ */
+element_t *q_nth(struct list_head *head, int k);
+
 /**
  * q_delete_mid() - Delete the middle node in queue
  * @head: header of queue
@@ -136,6 +395,12 @@ int q_size(struct list_head *head);
  * ⌊n / 2⌋th node from the start using 0-based indexing.
  * If there're six elements, the third member should be returned.
  *
+ * Queues keep a cursor near their middle node, unless q_mid_mode is off, so
+ * this takes amortized constant time: the cursor moves at most one step for
+ * each insertion or removal since the last call. After operations that
+ * rearrange the whole queue, such as sorting, the first call walks to the
+ * middle node.
+ *
  * Reference:
  * https://leetcode.com/problems/delete-the-middle-node-of-a-linked-list/
  *
@@ -155,6 +420,20 @@ bool q_delete_mid(struct list_head *head);
  */
 bool q_delete_dup(struct list_head *head);
 
+/**
+ * q_delete_dup_unsorted() - Delete all nodes whose string occurs more than
+ *                           once, without requiring the queue to be sorted.
+ * @head: header of queue
+ *
+ * The remaining nodes keep their original order. The work takes linear time,
+ * with a hash table kept in a scratch buffer that the queue reuses for later
+ * calls and releases with the queue.
+ *
+ * Return: true for success, false if list is NULL or the table could not be
+ * allocated.
+ */
+bool q_delete_dup_unsorted(struct list_head *head);
+
 /**
  * q_swap() - Swap every two adjacent nodes
  * @head: header of queue
@@ -164,6 +443,36 @@ bool q_delete_dup(struct list_head *head);
  */
 void q_swap(struct list_head *head);
 
+/**
+ * q_sync() - Relink the nodes of queue in queue order
+ * @head: header of queue
+ *
+ * A queue reversed by q_reverse() may keep its nodes linked back to front
+ * until some operation needs them in order. Code walking the nodes of a queue
+ * directly must call this first. The queue operations do so themselves.
+ */
+void q_sync(struct list_head *head);
+
+/**
+ * q_next() - Node after a node of queue, in queue order
+ * @head: header of queue
+ * @node: a node of queue, or @head to get the first node
+ *
+ * Walks the queue whether or not its nodes are linked in order.
+ *
+ * Return: the next node, or @head after the last one
+ */
+struct list_head *q_next(struct list_head *head, struct list_head *node);
+
+/**
+ * q_prev() - Node before a node of queue, in queue order
+ * @head: header of queue
+ * @node: a node of queue, or @head to get the last node
+ *
+ * Return: the previous node, or @head before the first one
+ */
+struct list_head *q_prev(struct list_head *head, struct list_head *node);
+
 /**
  * q_reverse() - Reverse elements in queue
  * @head: header of queue
@@ -183,7 +492,8 @@ void q_reverse(struct list_head *head);
  * linked list.
  *
  * No effect if queue is NULL or empty. If there has only one element, do
- * nothing.
+ * nothing. The nodes left over after the last group of k keep their order,
+ * unless q_ktail_mode is set.
  *
  * Reference:
  * https://leetcode.com/problems/reverse-nodes-in-k-group/
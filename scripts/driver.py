@@ -35,7 +35,26 @@ class Tracer:
         14: "trace-14-perf",
         15: "trace-15-perf",
         16: "trace-16-perf",
-        17: "trace-17-complexity"
+        17: "trace-17-complexity",
+        18: "trace-18-perf",
+        19: "trace-19-perf",
+        20: "trace-20-string",
+        21: "trace-21-perf",
+        22: "trace-22-perf",
+        23: "trace-23-ops",
+        24: "trace-24-ops",
+        25: "trace-25-ops",
+        26: "trace-26-ops",
+        27: "trace-27-ops",
+        28: "trace-28-ops",
+        29: "trace-29-ops",
+        30: "trace-30-ops",
+        31: "trace-31-ops",
+        32: "trace-32-ops",
+        33: "trace-33-perf",
+        34: "trace-34-ops",
+        35: "trace-35-ops",
+        36: "trace-36-ops"
     }
 
     traceProbs = {
@@ -55,10 +74,29 @@ class Tracer:
         14: "Trace-14",
         15: "Trace-15",
         16: "Trace-16",
-        17: "Trace-17"
+        17: "Trace-17",
+        18: "Trace-18",
+        19: "Trace-19",
+        20: "Trace-20",
+        21: "Trace-21",
+        22: "Trace-22",
+        23: "Trace-23",
+        24: "Trace-24",
+        25: "Trace-25",
+        26: "Trace-26",
+        27: "Trace-27",
+        28: "Trace-28",
+        29: "Trace-29",
+        30: "Trace-30",
+        31: "Trace-31",
+        32: "Trace-32",
+        33: "Trace-33",
+        34: "Trace-34",
+        35: "Trace-35",
+        36: "Trace-36"
     }
 
-    maxScores = [0, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 5]
+    maxScores = [0, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 5, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6, 6]
 
     RED = '\033[91m'
     GREEN = '\033[92m'
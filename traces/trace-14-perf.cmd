@@ -2,7 +2,7 @@
 option fail 0
 option malloc 0
 new
-ih dolphin 1000000
-it gerbil 1000000
+time ih dolphin 1000000
+time it gerbil 1000000
 reverse
 sort
@@ -0,0 +1,3004 @@
+# Test performance of merge with 1000 sorted queues of 1000 elements each
+option fail 0
+option malloc 0
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+new
+it RAND 1000
+sort
+merge
@@ -0,0 +1,10 @@
+# Test performance of insert_tail, reverse, and sort with slab allocation
+option fail 0
+option malloc 0
+option slab 1
+new
+ih dolphin 1000000
+it gerbil 1000000
+reverse
+sort
+free
@@ -0,0 +1,32 @@
+# Test of sort and dedup on strings sharing their first 8 characters,
+# with list_sort and with radix sort
+option fail 0
+option malloc 0
+new
+it aardvarkz
+it aardvark
+it aardvarka
+it aardvarkaardvarkb
+it aardvar
+it aardvarkz
+it aardvarkaardvarka
+it aardvarkaa
+sort
+dedup
+rh aardvar
+rh aardvark
+rh aardvarka
+rh aardvarkaa
+rh aardvarkaardvarka
+rh aardvarkaardvarkb
+size
+free
+option radix 64
+new
+ih aardvarkaardvarkb 100
+ih aardvar 100
+it aardvarkaardvarka 100
+ih RAND 1000
+it aardvark 100
+sort
+free
@@ -0,0 +1,14 @@
+# Test performance of sort split across 4 threads, with and without radix sort
+option fail 0
+option malloc 0
+option threads 4
+new
+ih RAND 200000
+it gerbil 100000
+sort
+reverse
+sort
+option radix 0
+reverse
+sort
+free
@@ -0,0 +1,19 @@
+# Test performance of sort on sorted, reverse-sorted and nearly sorted input
+option fail 0
+option malloc 0
+new
+ih RAND 500000
+sort
+sort
+reverse
+sort
+it aardvark 1000
+ih zebra 1000
+sort
+option radix 0
+reverse
+sort
+sort
+it aardvark 1000
+sort
+free
@@ -0,0 +1,29 @@
+# Test of delete_mid mixed with insert, remove, reverse, swap and sort
+option fail 0
+option malloc 0
+new
+it a
+it b
+it c
+it d
+it e
+it f
+dm
+ih z
+dm
+reverse
+dm
+swap
+dm
+rt a
+dm
+it y
+ih x
+sort
+it w
+dm
+rh e
+rh x
+rh w
+size
+free
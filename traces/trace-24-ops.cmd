@@ -0,0 +1,29 @@
+# Test of dedup on unsorted queues, keeping the order of distinct strings
+option fail 0
+option malloc 0
+new
+dedup unsorted
+it gerbil
+it bear
+it dolphin
+it bear
+it meerkat_panda_squirrel
+it gerbil
+it meerkat_panda_squirrel
+it meerkat_panda_vulture
+it bear
+it vulture
+dedup unsorted
+dm
+ih gerbil
+ih gerbil
+it vulture
+option prefix 0
+dedup unsorted
+option prefix 1
+size
+it RAND 100000
+dedup unsorted
+reverse
+dedup unsorted
+free
@@ -0,0 +1,23 @@
+# Test of removing several elements at once from head and tail
+option fail 10
+option malloc 0
+new
+ih b 3
+ih a 2
+it c 4
+rh a 2
+rt c 3
+dm
+size
+rh * 3
+rt c 1
+ih dolphin 4
+it gerbil_meerkat_squirrel 3
+option length 8
+rt gerbil_meerkat_squirrel 3
+option length 1024
+rh dolphin 5
+size
+it x
+rt x 2
+free
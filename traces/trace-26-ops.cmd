@@ -0,0 +1,20 @@
+# Test of remove_head and remove_tail without copying the string out
+option fail 10
+option malloc 0
+option nocopy 1
+new
+ih gerbil
+ih bear
+it dolphin
+it meerkat_panda_squirrel
+rh bear
+rt meerkat_panda_squirrel
+option length 4
+rh gerb
+option length 1024
+rt dolphin
+rh
+option nocopy 0
+it vulture
+rt vulture
+free
@@ -0,0 +1,35 @@
+# Test of the ring backend across block boundaries, with merge
+option fail 0
+option malloc 0
+option backend ring
+new
+it kiwi 300
+ih gnu 300
+rh gnu 300
+rt kiwi 299
+it a_string_too_long_for_a_ring_slot
+ih wombat
+dm
+rh wombat
+rt a_string_too_long_for_a_ring_slot
+it lemur 600
+rh * 550
+rh lemur 50
+it yak
+ih bat
+new
+it cat
+it emu
+new
+it ant
+it dog
+ih ant
+merge
+rh ant
+rh ant
+rh bat
+rh cat
+dm
+rt yak
+rt dog
+free
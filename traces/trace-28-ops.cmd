@@ -0,0 +1,6 @@
+# Test of the concurrent queue with several producers and consumers
+option fail 0
+option malloc 0
+stress 2 2 10000
+stress 3 1 5000
+stress 1 3 5000
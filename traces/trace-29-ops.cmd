@@ -0,0 +1,73 @@
+# Test of operations at both ends and in the middle of reversed queues
+option fail 0
+option malloc 0
+new
+it a
+it b
+it c
+it d
+it e
+reverse
+ih f
+it z
+rh f
+rt z
+rh e
+rt a
+dm
+size
+reverse
+reverse
+it y 2
+ih x 3
+reverse
+rh y 2
+rt x 2
+option length 8
+it meerkat_panda_squirrel 2
+reverse
+rh meerkat_panda_squirrel 2
+option length 1024
+dm
+rh x
+rt b
+size
+ih g
+ih h
+it i
+reverse
+swap
+rh g
+rh i
+rh h
+it dolphin
+it bear
+it gerbil
+reverse
+sort
+rh bear
+ih a
+it b
+reverse
+descend
+rh gerbil
+rh dolphin
+rh a
+it d
+it b
+reverse
+new
+it a
+it c
+merge
+rh a
+rh b
+rh c
+rh d
+option lazyrev 0
+it c 3
+it b
+reverse
+rh b
+rh c 3
+free
@@ -0,0 +1,42 @@
+# Test of reverseK with and without reversing the last, shorter group
+option fail 0
+option malloc 0
+new
+it a
+it b
+it c
+it d
+it e
+it f
+it g
+reverseK 3
+dm
+rh c
+rh b
+rh a
+rh e
+rh d
+rh g
+it a
+it b
+it c
+it d
+it e
+option ktail 1
+reverseK 2
+rh b
+rh a
+rh d
+rh c
+rh e
+it a
+it b
+it c
+reverse
+reverseK 5
+rh a
+rt c
+reverseK 1
+reverseK 0
+rh b
+free
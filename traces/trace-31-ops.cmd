@@ -0,0 +1,24 @@
+# Test of freeing queues whose elements live in slabs, rings and separate blocks
+option fail 0
+option malloc 0
+option slab 1
+new
+it a
+it b
+option slab 0
+new
+it c
+it d_long_string_out_of_line_for_sure_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+option backend ring
+new
+it e
+it f_long_string_out_of_line_for_sure_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+merge
+rh a
+rt f_long_string_out_of_line_for_sure_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+free
+option slab 1
+option backend list
+new
+it g_long_string_out_of_line_for_sure_xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx
+free
@@ -0,0 +1,46 @@
+# Test of insert_sorted, mixed with operations which keep or drop its index
+option fail 0
+option malloc 0
+option skip 1
+new
+is d
+is b
+is f
+is a
+is c
+is e
+is c
+rh a
+rt f
+is a
+is g
+dm
+size
+reverse
+is b
+sort
+rh a
+rh b
+rh b
+rh c
+rh d
+rh e
+rh g
+is zebra
+ih aardvark
+it zoo
+is gerbil_meerkat_squirrel_vulture_panda
+is lion
+rh aardvark
+rt zoo
+rh gerbil_meerkat_squirrel_vulture_panda
+rh lion
+rh zebra
+option skip 0
+is b
+is a
+is c
+rt c
+rh a
+rh b
+free
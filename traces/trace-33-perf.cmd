@@ -0,0 +1,210 @@
+# Test performance of insert_sorted against insert_tail followed by sort
+# 100 rounds of it and sort on 50000 elements take about as long as 100000
+# sorted insertions, which are expected to fail without the skip-list index
+option fail 0
+option malloc 0
+new
+ih RAND 50000
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+it RAND
+sort
+is RAND 100000
+free
@@ -0,0 +1,69 @@
+# Test of find and nth, mixed with operations which keep or drop their index
+option fail 0
+option malloc 0
+new
+find a
+nth 0
+it b
+it a
+ih c
+it a
+it b
+find a
+find b
+find c
+find d
+nth 0
+nth 4
+nth 5
+nth -1
+rh c
+find b
+rh b
+find b
+rt b
+find b
+rt a
+find a
+ih a
+find a
+nth 0
+reverse
+find a
+nth 0
+it c
+ih d
+find c
+find d
+dm
+find a
+swap
+nth 1
+sort
+find a
+nth 2
+is bb
+find bb
+dedup
+find a
+ih gerbil_meerkat_squirrel_vulture_panda
+it gerbil_meerkat_squirrel_vulture_panda
+find gerbil_meerkat_squirrel_vulture_panda
+rh gerbil_meerkat_squirrel_vulture_panda
+find gerbil_meerkat_squirrel_vulture_panda
+it RAND 1000
+nth 999
+reverseK 3
+nth 1
+find gerbil_meerkat_squirrel_vulture_panda
+sort
+new
+it x
+it y
+merge
+find x
+nth 1
+option index 0
+find y
+nth 0
+free
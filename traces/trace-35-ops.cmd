@@ -0,0 +1,18 @@
+# Test of dedup on queues which end with a run of duplicates
+option fail 0
+option malloc 0
+new
+ih a 2
+dedup
+size
+ih b 3
+it e
+it c 2
+dedup
+size
+it d
+it d
+dedup
+size
+rh e
+free
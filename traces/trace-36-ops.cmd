@@ -0,0 +1,14 @@
+# Test of descend on queues of a single element
+option fail 0
+option malloc 0
+new
+ih e
+descend
+size
+rh e
+ih a
+it b
+descend
+size
+rt b
+free